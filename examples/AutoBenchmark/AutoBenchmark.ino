@@ -36,9 +36,7 @@
 
 #if defined(EPOXY_DUINO) || defined(ARDUINO_ARCH_AVR)
   #include <digitalWriteFast.h>
-  #include <ace_button/fast/ButtonConfigFast1.h>
-  #include <ace_button/fast/ButtonConfigFast2.h>
-  #include <ace_button/fast/ButtonConfigFast3.h>
+  #include <ace_button/fast/ButtonConfigFast.h>
 #endif
 using ace_common::TimingStats;
 using namespace ace_button;
@@ -64,28 +62,33 @@ AceButton simpleButton(&buttonConfig);
 //----------------------------------------------------------------------------
 
 #if defined(EPOXY_DUINO) || defined(ARDUINO_ARCH_AVR)
-  // Create buttons for ButtonConfigFast{1,2,3}
+  // Create buttons for ButtonConfigFast<> with 1, 2, 3 and 8 pins.
   // Physical pin numbers attached to the buttons.
   const uint8_t BUTTON0_PHYSICAL_PIN = 4;
   const uint8_t BUTTON1_PHYSICAL_PIN = 5;
   const uint8_t BUTTON2_PHYSICAL_PIN = 6;
+  const uint8_t BUTTON3_PHYSICAL_PIN = 7;
+  const uint8_t BUTTON4_PHYSICAL_PIN = 8;
+  const uint8_t BUTTON5_PHYSICAL_PIN = 9;
+  const uint8_t BUTTON6_PHYSICAL_PIN = 10;
+  const uint8_t BUTTON7_PHYSICAL_PIN = 11;
 
   // Virtual pin numbers attached to the buttons.
   const uint8_t BUTTON0_PIN = 0;
   const uint8_t BUTTON1_PIN = 1;
   const uint8_t BUTTON2_PIN = 2;
 
-  ButtonConfigFast1<BUTTON0_PHYSICAL_PIN> buttonConfigFast1;
+  ButtonConfigFast<BUTTON0_PHYSICAL_PIN> buttonConfigFast1;
   AceButton buttonF1B0(&buttonConfigFast1, BUTTON0_PIN);
 
-  ButtonConfigFast2<
+  ButtonConfigFast<
       BUTTON0_PHYSICAL_PIN,
       BUTTON1_PHYSICAL_PIN
   > buttonConfigFast2;
   AceButton buttonF2B0(&buttonConfigFast2, BUTTON0_PIN);
   AceButton buttonF2B1(&buttonConfigFast2, BUTTON1_PIN);
 
-  ButtonConfigFast3<
+  ButtonConfigFast<
       BUTTON0_PHYSICAL_PIN,
       BUTTON1_PHYSICAL_PIN,
       BUTTON2_PHYSICAL_PIN
@@ -94,6 +97,21 @@ AceButton simpleButton(&buttonConfig);
   AceButton buttonF3B1(&buttonConfigFast3, BUTTON1_PIN);
   AceButton buttonF3B2(&buttonConfigFast3, BUTTON2_PIN);
 
+  // An array of 8 buttons, to show how ButtonConfigFast<> scales beyond the
+  // 3 pins supported by the old ButtonConfigFast3.
+  const uint8_t NUM_FAST8_BUTTONS = 8;
+  ButtonConfigFast<
+      BUTTON0_PHYSICAL_PIN,
+      BUTTON1_PHYSICAL_PIN,
+      BUTTON2_PHYSICAL_PIN,
+      BUTTON3_PHYSICAL_PIN,
+      BUTTON4_PHYSICAL_PIN,
+      BUTTON5_PHYSICAL_PIN,
+      BUTTON6_PHYSICAL_PIN,
+      BUTTON7_PHYSICAL_PIN
+  > buttonConfigFast8;
+  AceButton buttonsF8[NUM_FAST8_BUTTONS];
+
 #endif
 
 //----------------------------------------------------------------------------
@@ -178,11 +196,12 @@ const uint8_t LOOP_MODE_LONG_PRESS = 5;
 const uint8_t LOOP_MODE_BUTTON_CONFIG_FAST1 = 6;
 const uint8_t LOOP_MODE_BUTTON_CONFIG_FAST2 = 7;
 const uint8_t LOOP_MODE_BUTTON_CONFIG_FAST3 = 8;
-const uint8_t LOOP_MODE_ENCODED_4TO2_BUTTON_CONFIG = 9;
-const uint8_t LOOP_MODE_ENCODED_8TO3_BUTTON_CONFIG = 10;
-const uint8_t LOOP_MODE_ENCODED_BUTTON_CONFIG = 11;
-const uint8_t LOOP_MODE_LADDER_BUTTON_CONFIG = 12;
-const uint8_t LOOP_MODE_END = 13;
+const uint8_t LOOP_MODE_BUTTON_CONFIG_FAST8 = 9;
+const uint8_t LOOP_MODE_ENCODED_4TO2_BUTTON_CONFIG = 10;
+const uint8_t LOOP_MODE_ENCODED_8TO3_BUTTON_CONFIG = 11;
+const uint8_t LOOP_MODE_ENCODED_BUTTON_CONFIG = 12;
+const uint8_t LOOP_MODE_LADDER_BUTTON_CONFIG = 13;
+const uint8_t LOOP_MODE_END = 14;
 uint8_t loopMode;
 uint8_t loopEventType;
 
@@ -259,6 +278,15 @@ void checkSimpleButton() {
     uint16_t elapsedMicros = micros() - startMicros;
     stats.update(elapsedMicros);
   }
+
+  void checkButtonConfigFast8() {
+    uint16_t startMicros = micros();
+    for (uint8_t i = 0; i < NUM_FAST8_BUTTONS; i++) {
+      buttonsF8[i].check();
+    }
+    uint16_t elapsedMicros = micros() - startMicros;
+    stats.update(elapsedMicros);
+  }
 #endif
 
 void checkEncoded4To2Buttons() {
@@ -430,6 +458,18 @@ void loopCheckButtonConfigFast3() {
   }
 }
 
+void loopCheckButtonConfigFast8() {
+  static unsigned long start = millis();
+
+  checkButtonConfigFast8();
+
+  unsigned long elapsed = millis() - start;
+  if (elapsed > STATS_PRINT_INTERVAL) {
+    printStats(F("ButtonConfigFast8"));
+    nextMode();
+  }
+}
+
 #endif
 
 void loopEncoded4To2ButtonConfig() {
@@ -506,13 +546,13 @@ void setup() {
 
 #if defined(EPOXY_DUINO) || defined(ARDUINO_ARCH_AVR)
   SERIAL_PORT_MONITOR.print(F("sizeof(ButtonConfigFast1<>): "));
-  SERIAL_PORT_MONITOR.println(sizeof(ButtonConfigFast1<1>));
+  SERIAL_PORT_MONITOR.println(sizeof(ButtonConfigFast<1>));
 
   SERIAL_PORT_MONITOR.print(F("sizeof(ButtonConfigFast2<>): "));
-  SERIAL_PORT_MONITOR.println(sizeof(ButtonConfigFast2<1, 2>));
+  SERIAL_PORT_MONITOR.println(sizeof(ButtonConfigFast<1, 2>));
 
   SERIAL_PORT_MONITOR.print(F("sizeof(ButtonConfigFast3<>): "));
-  SERIAL_PORT_MONITOR.println(sizeof(ButtonConfigFast3<1, 2, 3>));
+  SERIAL_PORT_MONITOR.println(sizeof(ButtonConfigFast<1, 2, 3>));
 #endif
 
   SERIAL_PORT_MONITOR.print(F("sizeof(Encoded4To2ButtonConfig): "));
@@ -580,6 +620,21 @@ void setup() {
     buttonConfigFast3.setFeature(ButtonConfig::kFeatureLongPress);
     buttonConfigFast3.setFeature(ButtonConfig::kFeatureRepeatPress);
     buttonConfigFast3.setFeature(ButtonConfig::kFeatureSuppressAll);
+
+    // Configure ButtonConfigFast8
+  #if USE_EVENT_HANDLER_CLASS
+    buttonConfigFast8.setIEventHandler(&handleEvent);
+  #else
+    buttonConfigFast8.setEventHandler(handleEvent);
+  #endif
+    buttonConfigFast8.setFeature(ButtonConfig::kFeatureClick);
+    buttonConfigFast8.setFeature(ButtonConfig::kFeatureDoubleClick);
+    buttonConfigFast8.setFeature(ButtonConfig::kFeatureLongPress);
+    buttonConfigFast8.setFeature(ButtonConfig::kFeatureRepeatPress);
+    buttonConfigFast8.setFeature(ButtonConfig::kFeatureSuppressAll);
+    for (uint8_t i = 0; i < NUM_FAST8_BUTTONS; i++) {
+      buttonsF8[i].init(&buttonConfigFast8, i);
+    }
 #endif
 
 #if USE_EVENT_HANDLER_CLASS
@@ -674,6 +729,13 @@ void loop() {
         nextMode();
       #endif
       break;
+    case LOOP_MODE_BUTTON_CONFIG_FAST8:
+      #if defined(EPOXY_DUINO) || defined(ARDUINO_ARCH_AVR)
+        loopCheckButtonConfigFast8();
+      #else
+        nextMode();
+      #endif
+      break;
 
     case LOOP_MODE_ENCODED_4TO2_BUTTON_CONFIG:
       loopEncoded4To2ButtonConfig();
@@ -16,7 +16,7 @@ class ProfilingButtonConfig: public ButtonConfig {
     ProfilingButtonConfig():
         mButtonState(HIGH) {}
 
-    int readButton(uint8_t /* pin */) override { return mButtonState; }
+    int readButton(PinType /* pin */) override { return mButtonState; }
 
     /** Set the state of the fake physical button. */
     void setButtonState(int buttonState) { mButtonState = buttonState; }
@@ -153,6 +153,17 @@ number of `TimingStats::update()` calls that were made.
     * Increases `sizeof(ButtonConfig)` by 2 bytes to 18 on AVR processors`,
       no change on 32-bit processors due to padding in struct.
 
+**Unreleased**
+* Replace `ButtonConfigFast1<>`, `ButtonConfigFast2<>`, and
+  `ButtonConfigFast3<>` with the variadic `ButtonConfigFast<>`.
+    * Add `ButtonConfigFast8` benchmark which checks 8 buttons using a single
+      `ButtonConfigFast<>` with 8 pins.
+    * The `readButton()` of `ButtonConfigFast<>` with 1 to 3 pins compiles to
+      the same code as the `switch` of the old classes (54 bytes for 3 pins
+      in both cases, with `g++ -Os` on x86-64), so the `ButtonConfigFast1` to
+      `ButtonConfigFast3` results below are still valid. The AVR results have
+      not been regenerated yet, so the `ButtonConfigFast8` row is missing.
+
 ## Results
 
 The following table shows the minimum, average, and maximum (min/avg/max)
@@ -169,11 +180,17 @@ time taken for a number of scenarios in units of microseconds:
 * long_press/repeat_press
     * one `AceButton::check()` call with LongPress and RepeatPress events
 * ButtonConfigFast1 (AVR-only)
-    * 1 x `AceButton::check()` calls using `ButtonConfigFast1<>` with no events
+    * 1 x `AceButton::check()` calls using `ButtonConfigFast<>` with 1 pin and
+      no events
 * ButtonConfigFast2 (AVR-only)
-    * 2 x `AceButton::check()` calls using `ButtonConfigFast2<>` with no events
+    * 2 x `AceButton::check()` calls using `ButtonConfigFast<>` with 2 pins and
+      no events
 * ButtonConfigFast3 (AVR-only)
-    * 3 x `AceButton::check()` calls using `ButtonConfigFast3<>` with no events
+    * 3 x `AceButton::check()` calls using `ButtonConfigFast<>` with 3 pins and
+      no events
+* ButtonConfigFast8 (AVR-only)
+    * 8 x `AceButton::check()` calls using `ButtonConfigFast<>` with 8 pins and
+      no events
 * Encoded4To2ButtonConfig
     * 3 x `AceButton::check()` calls using `Encoded4To2ButtonConfig` with no
       events
@@ -39,7 +39,7 @@ class CapacitiveConfig: public ButtonConfig {
     // The threshold value which is considered to be a "touch" on the switch.
     static const long kTouchThreshold = 100;
 
-    int readButton(uint8_t /*pin*/) override {
+    int readButton(PinType /*pin*/) override {
       long total =  mSensor.capacitiveSensor(kSamples);
       return (total > kTouchThreshold) ? LOW : HIGH;
     }
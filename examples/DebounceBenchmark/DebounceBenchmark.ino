@@ -0,0 +1,371 @@
+/*
+ * A benchmark which runs natively on Linux or MacOS using EpoxyDuino
+ * (https://github.com/bxparks/EpoxyDuino). It compares the debouncing of the
+ * ButtonConfig, EncodedButtonConfig and LadderButtonConfig classes for several
+ * debounce delays, using the realistic noisy input of the contact-bounce
+ * models of testing::BounceGenerator (bounces, EMI spikes, and slow ramps of a
+ * resistor ladder).
+ *
+ * Each run presses and releases one button 1000 times, with random hold and
+ * gap durations from a fixed seed, and polls the config every millisecond of
+ * the simulated clock. The Pressed and Released events are matched against the
+ * intended presses and releases. The results are printed as CSV:
+ *
+ * @verbatim
+ * config,model,debounce,presses,missed,false,press_avg,press_max,release_avg
+ * ButtonConfig,ideal,5,1000,0,0,5.0,5,5.0
+ * ...
+ * @endverbatim
+ *
+ * where:
+ *
+ *  * debounce: ButtonConfig::getDebounceDelay(), in ms, also used as the
+ *    number of samples of ButtonConfig::setDebounceSamples() if the
+ *    ACE_BUTTON_DEBOUNCE algorithm of AceButton counts samples (at most 8 for
+ *    the ButtonConfig with ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER), or "auto" for
+ *    the delay adjusted by ButtonConfig::enableDebounceTuner(), if
+ *    ACE_BUTTON_BOUNCE_STATS is enabled
+ *  * presses: number of presses (and releases) of the button
+ *  * missed: number of presses or releases without their Pressed or Released
+ *    event
+ *  * false: number of extra Pressed or Released events, including the events
+ *    of the other buttons of the Encoded and Ladder configs
+ *  * press_avg, press_max: latency of the Pressed event from the press, in ms
+ *  * release_avg: latency of the Released event from the release, in ms
+ *
+ * Depends on:
+ *
+ *  * https://github.com/bxparks/AceButton
+ *  * https://github.com/bxparks/EpoxyDuino
+ */
+
+#include <stdlib.h> // exit()
+#include <Arduino.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/TestableEncodedButtonConfig.h>
+#include <ace_button/testing/TestableLadderButtonConfig.h>
+#include <ace_button/testing/BounceGenerator.h>
+
+#if ! defined(EPOXY_DUINO)
+  #error This benchmark runs only on EpoxyDuino
+#endif
+
+using namespace ace_button;
+using namespace ace_button::testing;
+
+//-----------------------------------------------------------------------------
+// Configs under test. The benchmarked button has the id 0.
+//-----------------------------------------------------------------------------
+
+static const uint8_t NUM_BUTTONS = 3;
+
+static TestableButtonConfig buttonConfig;
+static AceButton button(&buttonConfig, 2, HIGH, 0);
+
+// The benchmarked button is the virtual pin 3 of the encoder. An EMI spike or a
+// bounce can only produce the "no button" code 0.
+static const uint8_t ENCODER_PINS[] = {2, 3};
+static AceButton encodedButtons[NUM_BUTTONS];
+static AceButton* const ENCODED_BUTTONS[] = {
+  &encodedButtons[0], &encodedButtons[1], &encodedButtons[2],
+};
+static TestableEncodedButtonConfig encodedConfig(
+    2, ENCODER_PINS, NUM_BUTTONS, ENCODED_BUTTONS);
+static const PinType ENCODED_VIRTUAL_PIN = 3;
+
+// The benchmarked button is at the ADC level 0. The ramp from the released
+// level 1023 down to 0 crosses the levels of the 2 other buttons.
+static const PinType NUM_LEVELS = NUM_BUTTONS + 1;
+static const uint16_t LEVELS[NUM_LEVELS] = {0, 341, 682, 1023};
+static AceButton ladderButtons[NUM_BUTTONS];
+static AceButton* const LADDER_BUTTONS[] = {
+  &ladderButtons[0], &ladderButtons[1], &ladderButtons[2],
+};
+static TestableLadderButtonConfig ladderConfig(
+    0, NUM_LEVELS, LEVELS, NUM_BUTTONS, LADDER_BUTTONS);
+
+/** Return the index of the ladder level, like LadderButtonConfig. */
+static PinType decodeLadder(uint16_t level) {
+  PinType i;
+  for (i = 0; i < NUM_LEVELS - 1; i++) {
+    if (level < (LEVELS[i] + LEVELS[i + 1]) / 2) return i;
+  }
+  return i;
+}
+
+//-----------------------------------------------------------------------------
+// Scoring of the events
+//-----------------------------------------------------------------------------
+
+// Events received since the last press of the script.
+static unsigned long pressTime;
+static unsigned long releaseTime;
+static uint16_t numPressed;
+static uint16_t numReleased;
+static uint16_t numOthers;
+
+// Results of a run.
+static uint16_t missed;
+static uint32_t falseEvents;
+static uint32_t pressLatencySum;
+static uint32_t pressLatencyMax;
+static uint32_t releaseLatencySum;
+static uint16_t numPressLatencies;
+static uint16_t numReleaseLatencies;
+
+static unsigned long simMillis;
+
+static void handleEvent(AceButton* button, uint8_t eventType,
+    uint8_t /*buttonState*/) {
+  if (button->getId() != 0) {
+    numOthers++;
+    return;
+  }
+
+  if (eventType == AceButton::kEventPressed) {
+    if (numPressed++ == 0) {
+      uint32_t latency = simMillis - pressTime;
+      pressLatencySum += latency;
+      numPressLatencies++;
+      if (latency > pressLatencyMax) pressLatencyMax = latency;
+    }
+  } else if (eventType == AceButton::kEventReleased) {
+    // A Released event before the release is caused by the noise.
+    if (simMillis < releaseTime) {
+      numOthers++;
+    } else if (numReleased++ == 0) {
+      releaseLatencySum += simMillis - releaseTime;
+      numReleaseLatencies++;
+    }
+  }
+}
+
+/** Score the events of the last press and release. */
+static void scorePress() {
+  if (numPressed == 0) missed++;
+  if (numReleased == 0) missed++;
+  if (numPressed > 1) falseEvents += numPressed - 1;
+  if (numReleased > 1) falseEvents += numReleased - 1;
+  falseEvents += numOthers;
+  numPressed = 0;
+  numReleased = 0;
+  numOthers = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Runs
+//-----------------------------------------------------------------------------
+
+struct Model {
+  const char* name;
+  BounceModel model;
+};
+
+// maxBounces, bounceTime, rampTime, spikeInterval, spikeWidth
+static const Model MODELS[] = {
+  {"ideal", {0, 0, 0, 0, 0}},
+  {"bounce", {5, 5, 0, 0, 0}},
+  {"heavy_bounce", {15, 30, 0, 0, 0}},
+  {"emi", {3, 3, 0, 200, 1}},
+  {"emi_wide", {3, 3, 0, 200, 8}},
+  {"ramp", {3, 3, 20, 0, 0}},
+};
+static const uint8_t NUM_MODELS = sizeof(MODELS) / sizeof(MODELS[0]);
+
+static const uint16_t DEBOUNCE_DELAYS[] = {5, 10, 20, 40};
+static const uint8_t NUM_DEBOUNCE_DELAYS =
+    sizeof(DEBOUNCE_DELAYS) / sizeof(DEBOUNCE_DELAYS[0]);
+
+#if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER
+// The shift register of AceButton holds at most 8 samples.
+static const uint16_t MAX_DEBOUNCE_SAMPLES = 8;
+#elif ACE_BUTTON_DEBOUNCE_SAMPLED
+static const uint16_t MAX_DEBOUNCE_SAMPLES = 255;
+#endif
+
+enum ConfigType { kButtonConfig, kEncodedConfig, kLadderConfig };
+static const char* const CONFIG_NAMES[] = {
+  "ButtonConfig", "EncodedButtonConfig", "LadderButtonConfig",
+};
+
+// The DebounceTuner adjusts the debounce delay in milliseconds, so it does not
+// apply to the sampled algorithms.
+#define BENCHMARK_TUNER \
+    (ACE_BUTTON_BOUNCE_STATS && ! ACE_BUTTON_DEBOUNCE_SAMPLED)
+
+#if BENCHMARK_TUNER
+// Bounds of the debounce delay adjusted by the DebounceTuner.
+static const uint16_t TUNER_MIN_DELAY = 2;
+static const uint16_t TUNER_MAX_DELAY = 50;
+#endif
+
+static const uint16_t NUM_PRESSES = 1000;
+static const uint32_t SEED = 12345;
+
+/** Set the raw input of the config at the time 'now', and check it. */
+static void poll(ConfigType type, BounceGenerator& generator,
+    unsigned long now) {
+  simMillis = now;
+  switch (type) {
+    case kButtonConfig:
+      buttonConfig.setClock(now);
+      buttonConfig.setButtonState(generator.isClosed(now) ? LOW : HIGH);
+      button.check();
+      break;
+    case kEncodedConfig:
+      encodedConfig.setClock(now);
+      encodedConfig.setVirtualPin(
+          generator.isClosed(now) ? ENCODED_VIRTUAL_PIN : 0);
+      encodedConfig.checkButtons();
+      break;
+    case kLadderConfig: {
+      ladderConfig.setClock(now);
+      uint16_t level = (uint32_t) 1023
+          * (BounceGenerator::kLevelClosed - generator.getLevel(now))
+          / BounceGenerator::kLevelClosed;
+      ladderConfig.setVirtualPin(decodeLadder(level));
+      ladderConfig.checkButtons();
+      break;
+    }
+  }
+}
+
+static ButtonConfig& initConfig(ConfigType type) {
+  switch (type) {
+    case kEncodedConfig:
+      encodedConfig.init();
+      for (uint8_t i = 0; i < NUM_BUTTONS; i++) {
+        // Button 0 is the virtual pin 3.
+        encodedButtons[i].init(&encodedConfig, 3 - i, HIGH, i);
+      }
+      return encodedConfig;
+    case kLadderConfig:
+      ladderConfig.init();
+      ladderConfig.setVirtualPin(NUM_LEVELS - 1);
+      for (uint8_t i = 0; i < NUM_BUTTONS; i++) {
+        ladderButtons[i].init(&ladderConfig, i, HIGH, i);
+      }
+      return ladderConfig;
+    default:
+      buttonConfig.init();
+      button.init(2, HIGH, 0);
+      return buttonConfig;
+  }
+}
+
+// Run the benchmark. A debounceDelay of 0 starts with the default delay, and
+// lets the DebounceTuner adjust it.
+static void run(ConfigType type, const Model& model, uint16_t debounceDelay) {
+  ButtonConfig& config = initConfig(type);
+  config.setEventHandler(handleEvent);
+  config.setDebounceDelay(debounceDelay);
+#if ACE_BUTTON_DEBOUNCE_SAMPLED
+  // One sample per millisecond.
+  config.setDebounceSamples(debounceDelay);
+#endif
+#if BENCHMARK_TUNER
+  config.disableDebounceTuner();
+  if (debounceDelay == 0) {
+    config.setDebounceDelay(ButtonConfig::kDebounceDelay);
+    config.enableDebounceTuner(TUNER_MIN_DELAY, TUNER_MAX_DELAY);
+  }
+#endif
+
+  BounceGenerator generator(model.model, SEED);
+  missed = 0;
+  falseEvents = 0;
+  pressLatencySum = 0;
+  pressLatencyMax = 0;
+  releaseLatencySum = 0;
+  numPressLatencies = 0;
+  numReleaseLatencies = 0;
+  numPressed = 0;
+  numReleased = 0;
+  numOthers = 0;
+
+  // The script uses its own random sequence, so that it is the same for all
+  // the models and configs.
+  uint32_t random = SEED;
+  unsigned long now = 0;
+  pressTime = 0;
+  releaseTime = 0;
+  for (uint16_t i = 0; i <= NUM_PRESSES; i++) {
+    random = random * 1103515245 + 12345;
+    unsigned long nextPress = now + 150 + (random >> 8) % 850;
+    for (; now < nextPress; now++) poll(type, generator, now);
+    if (i > 0) scorePress();
+    if (i == NUM_PRESSES) break;
+
+    random = random * 1103515245 + 12345;
+    pressTime = now;
+    releaseTime = now + 80 + (random >> 8) % 520;
+    generator.setClosed(pressTime, true);
+    for (; now < releaseTime; now++) poll(type, generator, now);
+    generator.setClosed(releaseTime, false);
+  }
+
+  SERIAL_PORT_MONITOR.print(CONFIG_NAMES[type]);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(model.name);
+  SERIAL_PORT_MONITOR.print(',');
+  if (debounceDelay == 0) {
+    SERIAL_PORT_MONITOR.print(F("auto"));
+  } else {
+    SERIAL_PORT_MONITOR.print(debounceDelay);
+  }
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(NUM_PRESSES);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(missed);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(falseEvents);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(numPressLatencies
+      ? (double) pressLatencySum / numPressLatencies : 0, 1);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(pressLatencyMax);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.println(numReleaseLatencies
+      ? (double) releaseLatencySum / numReleaseLatencies : 0, 1);
+}
+
+//-----------------------------------------------------------------------------
+
+void setup() {
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready
+}
+
+void loop() {
+  SERIAL_PORT_MONITOR.println(
+    F("config,model,debounce,presses,missed,false,press_avg,press_max,"
+      "release_avg"));
+  for (uint8_t c = kButtonConfig; c <= kLadderConfig; c++) {
+    for (uint8_t m = 0; m < NUM_MODELS; m++) {
+    #if ACE_BUTTON_DEBOUNCE_SAMPLED
+      uint16_t previousDelay = 0;
+    #endif
+      for (uint8_t d = 0; d < NUM_DEBOUNCE_DELAYS; d++) {
+        uint16_t debounceDelay = DEBOUNCE_DELAYS[d];
+      #if ACE_BUTTON_DEBOUNCE_SAMPLED
+        // Label the rows of the ButtonConfig with the number of samples
+        // actually used by AceButton, and skip the duplicates. The Encoded and
+        // Ladder configs always debounce in milliseconds.
+        if (c == kButtonConfig) {
+          if (debounceDelay > MAX_DEBOUNCE_SAMPLES) {
+            debounceDelay = MAX_DEBOUNCE_SAMPLES;
+          }
+          if (debounceDelay == previousDelay) continue;
+          previousDelay = debounceDelay;
+        }
+      #endif
+        run((ConfigType) c, MODELS[m], debounceDelay);
+      }
+    #if BENCHMARK_TUNER
+      run((ConfigType) c, MODELS[m], 0);
+    #endif
+    }
+  }
+  exit(0);
+}
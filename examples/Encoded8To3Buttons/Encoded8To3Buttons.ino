@@ -25,6 +25,10 @@ static const uint8_t BUTTON_PIN2 = 4;
 // Each button is assigned to the virtual pin number (1-7) which comes from the
 // binary bit patterns of the 3 actual pins. Button b0 on virtual pin 0 cannot
 // be used because it is used to represent "no button pressed".
+//
+// If the GS output of a 74LS148 encoder is wired to another pin, pass it as
+// the optional 5th argument (after HIGH) so that only that pin is read while
+// no button is pressed.
 Encoded8To3ButtonConfig buttonConfig(BUTTON_PIN0, BUTTON_PIN1, BUTTON_PIN2);
 AceButton b1(&buttonConfig, 1);
 AceButton b2(&buttonConfig, 2);
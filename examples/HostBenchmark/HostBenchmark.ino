@@ -0,0 +1,405 @@
+/*
+ * A benchmark which runs natively on Linux or MacOS using EpoxyDuino
+ * (https://github.com/bxparks/EpoxyDuino). It runs the same scenarios as
+ * AutoBenchmark (idle, press/release, click, double click, long/repeat press,
+ * ButtonConfigFast, and each Encoded and Ladder config), but drives the
+ * AceButton library with a simulated millisecond clock instead of the real
+ * one, so that each scenario completes in a fraction of a second, and measures
+ * the elapsed wall time with nanosecond resolution.
+ *
+ * Each scenario is repeated with 1, 10, 100, 1000 and 10000 buttons. The
+ * results are printed as CSV, one line per (scenario, buttons) pair, so that
+ * they can be tracked across commits:
+ *
+ * @verbatim
+ * scenario,buttons,ticks,checks,events,ns_per_check,events_per_sec,status
+ * idle,1,2000,2000,0,8.1,0,ok
+ * ...
+ * @endverbatim
+ *
+ * where:
+ *
+ *  * ticks: number of simulated milliseconds
+ *  * checks: number of buttons processed, i.e. ticks * buttons
+ *  * events: number of events dispatched to the event handler
+ *  * ns_per_check: wall time divided by checks
+ *  * events_per_sec: events divided by the wall time
+ *  * status: 'ok', or 'ERROR' if the last event was not the expected one
+ *
+ * Depends on:
+ *
+ *  * https://github.com/bxparks/AceButton
+ *  * https://github.com/bxparks/EpoxyDuino
+ *  * https://github.com/bxparks/EpoxyDuino/tree/develop/libraries/EpoxyMockDigitalWriteFast
+ */
+
+#include <stdlib.h> // exit()
+#include <chrono>
+#include <Arduino.h>
+#include <AceButton.h>
+#include <digitalWriteFast.h>
+#include <ace_button/fast/ButtonConfigFast.h>
+
+#if ! defined(EPOXY_DUINO)
+  #error This benchmark runs only on EpoxyDuino
+#endif
+
+using namespace ace_button;
+
+//-----------------------------------------------------------------------------
+// Simulated environment
+//-----------------------------------------------------------------------------
+
+/** The simulated clock, in milliseconds, returned by every config. */
+static unsigned long simMillis;
+
+/** Button state returned by HostButtonConfig::readButton(). */
+static int simButtonState = HIGH;
+
+/** Virtual pin returned by HostLadderButtonConfig::getVirtualPin(). */
+static PinType simLadderVirtualPin;
+
+/**
+ * Replace the getClock() of a ButtonConfig class with the simulated clock.
+ */
+template <typename T>
+class HostClock: public T {
+  public:
+    using T::T;
+
+    unsigned long getClock() override { return simMillis; }
+};
+
+/** A ButtonConfig whose single physical button is simulated. */
+class HostButtonConfig: public HostClock<ButtonConfig> {
+  public:
+    int readButton(PinType /*pin*/) override { return simButtonState; }
+};
+
+/**
+ * A LadderButtonConfig which bypasses the analogRead(), whose emulation is not
+ * representative of the ADC of a microcontroller.
+ */
+class HostLadderButtonConfig: public HostClock<LadderButtonConfig> {
+  public:
+    using HostClock<LadderButtonConfig>::HostClock;
+
+  protected:
+    PinType getVirtualPin() const override { return simLadderVirtualPin; }
+};
+
+// Pins of the encoders.
+static const uint8_t ENCODER_PIN0 = 2;
+static const uint8_t ENCODER_PIN1 = 3;
+static const uint8_t ENCODER_PIN2 = 4;
+static const uint8_t NUM_ENCODER_PINS = 3;
+static const uint8_t ENCODER_PINS[NUM_ENCODER_PINS] = {
+  ENCODER_PIN0, ENCODER_PIN1, ENCODER_PIN2
+};
+
+/** Set the physical encoder pins to the pattern of the given virtual pin. */
+static void setEncoderVirtualPin(PinType virtualPin) {
+  for (uint8_t i = 0; i < NUM_ENCODER_PINS; i++) {
+    digitalReadValue(ENCODER_PINS[i], (virtualPin & (1 << i)) ? LOW : HIGH);
+  }
+}
+
+// Ladder levels for 7 buttons, identical to AutoBenchmark.
+static const uint8_t NUM_LADDER_LEVELS = 8;
+static const uint16_t LADDER_LEVELS[NUM_LADDER_LEVELS] = {
+  0, 133, 327, 512, 614, 788, 930, 1023
+};
+
+// Physical pins of ButtonConfigFast, identical to AutoBenchmark.
+using HostButtonConfigFast8 = HostClock<ButtonConfigFast<
+    4, 5, 6, 7, 8, 9, 10, 11>>;
+
+//-----------------------------------------------------------------------------
+// Buttons and configs
+//-----------------------------------------------------------------------------
+
+static const uint16_t MAX_BUTTONS = 10000;
+static const uint16_t NUM_SIZES = 5;
+static const uint16_t SIZES[NUM_SIZES] = {1, 10, 100, 1000, 10000};
+
+// Number of buttons in each bank of EncodedButtonConfig or LadderButtonConfig.
+static const uint8_t BANK_SIZE = 7;
+static const uint16_t MAX_BANKS = (MAX_BUTTONS + BANK_SIZE - 1) / BANK_SIZE;
+
+static AceButton buttons[MAX_BUTTONS];
+static AceButton* buttonPointers[MAX_BUTTONS];
+
+/**
+ * Return the id of the button at index 'i'. The ids are unique only if
+ * ACE_BUTTON_WIDE_PINS is enabled, otherwise IdType has 8 bits and they wrap
+ * around every 256 buttons. The event handler does not use them.
+ */
+static IdType buttonId(uint16_t i) {
+  return (IdType) i;
+}
+
+static HostButtonConfig buttonConfig;
+static HostButtonConfigFast8 buttonConfigFast8;
+static HostClock<Encoded4To2ButtonConfig> encoded4To2ButtonConfig(
+    ENCODER_PIN0, ENCODER_PIN1);
+static HostClock<Encoded8To3ButtonConfig> encoded8To3ButtonConfig(
+    ENCODER_PIN0, ENCODER_PIN1, ENCODER_PIN2);
+
+// Banks of 7 buttons each, created for each number of buttons. A single
+// EncodedButtonConfig or LadderButtonConfig is limited to 255 buttons unless
+// ACE_BUTTON_WIDE_PINS is enabled, and a real application with thousands of
+// buttons would use multiple banks anyway.
+static ButtonConfig* banks[MAX_BANKS];
+static uint16_t numBanks;
+static uint16_t numButtons;
+
+static uint32_t numEvents;
+static uint8_t lastEventType;
+
+static void handleEvent(AceButton* /*button*/, uint8_t eventType,
+    uint8_t /*buttonState*/) {
+  numEvents++;
+  lastEventType = eventType;
+}
+
+/** Enable all features of the given config, like AutoBenchmark. */
+static void configure(ButtonConfig& config) {
+  config.setEventHandler(handleEvent);
+  config.setFeature(ButtonConfig::kFeatureClick);
+  config.setFeature(ButtonConfig::kFeatureDoubleClick);
+  config.setFeature(ButtonConfig::kFeatureLongPress);
+  config.setFeature(ButtonConfig::kFeatureRepeatPress);
+  config.setFeature(ButtonConfig::kFeatureSuppressAll);
+}
+
+/** Bind 'n' buttons to 'config', with virtual pins cycling up to numPins. */
+static void bindButtons(ButtonConfig* config, uint16_t n, PinType firstPin,
+    PinType numPins) {
+  for (uint16_t i = 0; i < n; i++) {
+    buttons[i].init(config, firstPin + (i % numPins), HIGH, buttonId(i));
+  }
+}
+
+static void deleteBanks() {
+  for (uint16_t i = 0; i < numBanks; i++) {
+    delete banks[i];
+  }
+  numBanks = 0;
+}
+
+/** Create banks of EncodedButtonConfig, with virtual pins 1 to 7. */
+static void createEncodedBanks(uint16_t n) {
+  for (uint16_t i = 0; i < n; i++) {
+    buttons[i].init(nullptr, 1 + (i % BANK_SIZE), HIGH, buttonId(i));
+    buttonPointers[i] = &buttons[i];
+  }
+  for (uint16_t start = 0; start < n; start += BANK_SIZE) {
+    uint16_t size = (n - start < BANK_SIZE) ? n - start : BANK_SIZE;
+    auto* bank = new HostClock<EncodedButtonConfig>(
+        NUM_ENCODER_PINS, ENCODER_PINS, size, &buttonPointers[start]);
+    configure(*bank);
+    banks[numBanks++] = bank;
+  }
+}
+
+/** Create banks of LadderButtonConfig, with virtual pins 0 to 6. */
+static void createLadderBanks(uint16_t n) {
+  for (uint16_t i = 0; i < n; i++) {
+    buttons[i].init(nullptr, i % BANK_SIZE, HIGH, buttonId(i));
+    buttonPointers[i] = &buttons[i];
+  }
+  for (uint16_t start = 0; start < n; start += BANK_SIZE) {
+    uint16_t size = (n - start < BANK_SIZE) ? n - start : BANK_SIZE;
+    auto* bank = new HostLadderButtonConfig(
+        A0, NUM_LADDER_LEVELS, LADDER_LEVELS, size, &buttonPointers[start]);
+    configure(*bank);
+    banks[numBanks++] = bank;
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Scenarios
+//-----------------------------------------------------------------------------
+
+/** Call AceButton::check() on every button. */
+static void checkAll() {
+  for (uint16_t i = 0; i < numButtons; i++) {
+    buttons[i].check();
+  }
+}
+
+static void checkEncodedBanks() {
+  for (uint16_t i = 0; i < numBanks; i++) {
+    static_cast<EncodedButtonConfig*>(banks[i])->checkButtons();
+  }
+}
+
+static void checkLadderBanks() {
+  for (uint16_t i = 0; i < numBanks; i++) {
+    static_cast<LadderButtonConfig*>(banks[i])->checkButtons();
+  }
+}
+
+// Input scripts, using the same timelines as AutoBenchmark.
+
+static void inputIdle(unsigned long /*t*/) {}
+
+static void inputPressRelease(unsigned long t) {
+  simButtonState = (100 <= t && t < 1000) ? LOW : HIGH;
+}
+
+static void inputClick(unsigned long t) {
+  simButtonState = (100 <= t && t < 200) ? LOW : HIGH;
+}
+
+static void inputDoubleClick(unsigned long t) {
+  simButtonState = ((100 <= t && t < 200) || (300 <= t && t < 400))
+      ? LOW : HIGH;
+}
+
+static void inputLongPress(unsigned long t) {
+  simButtonState = (100 <= t) ? LOW : HIGH;
+}
+
+static void inputEncodedClick(unsigned long t) {
+  setEncoderVirtualPin((100 <= t && t < 200) ? 1 : 0);
+}
+
+static void inputLadderClick(unsigned long t) {
+  simLadderVirtualPin = (100 <= t && t < 200) ? 0 : NUM_LADDER_LEVELS - 1;
+}
+
+/** Setup functions, which bind 'n' buttons to the config under test. */
+
+static void setupSimple(uint16_t n) {
+  simButtonState = HIGH;
+  bindButtons(&buttonConfig, n, 0, 1);
+}
+
+static void setupFast8(uint16_t n) {
+  for (uint8_t pin = 4; pin <= 11; pin++) digitalReadValue(pin, HIGH);
+  bindButtons(&buttonConfigFast8, n, 0, 8);
+}
+
+static void setupEncoded4To2(uint16_t n) {
+  setEncoderVirtualPin(0);
+  bindButtons(&encoded4To2ButtonConfig, n, 1, 3);
+}
+
+static void setupEncoded8To3(uint16_t n) {
+  setEncoderVirtualPin(0);
+  bindButtons(&encoded8To3ButtonConfig, n, 1, 7);
+}
+
+static void setupEncoded(uint16_t n) {
+  setEncoderVirtualPin(0);
+  createEncodedBanks(n);
+}
+
+static void setupLadder(uint16_t n) {
+  simLadderVirtualPin = NUM_LADDER_LEVELS - 1;
+  createLadderBanks(n);
+}
+
+struct Scenario {
+  const char* name;
+  void (*setup)(uint16_t n);
+  void (*input)(unsigned long t);
+  void (*check)();
+
+  /** Expected last event type, or kNoEvent if no event is expected. */
+  uint8_t expectedEventType;
+};
+
+static const uint8_t kNoEvent = 0xFF;
+
+static const Scenario SCENARIOS[] = {
+  {"idle", setupSimple, inputIdle, checkAll, kNoEvent},
+  {"press/release", setupSimple, inputPressRelease, checkAll,
+      AceButton::kEventReleased},
+  {"click", setupSimple, inputClick, checkAll, AceButton::kEventClicked},
+  {"double_click", setupSimple, inputDoubleClick, checkAll,
+      AceButton::kEventDoubleClicked},
+  {"long_press/repeat_press", setupSimple, inputLongPress, checkAll,
+      AceButton::kEventRepeatPressed},
+  {"ButtonConfigFast8", setupFast8, inputIdle, checkAll, kNoEvent},
+  {"Encoded4To2ButtonConfig", setupEncoded4To2, inputIdle, checkAll,
+      kNoEvent},
+  {"Encoded8To3ButtonConfig", setupEncoded8To3, inputIdle, checkAll,
+      kNoEvent},
+  {"EncodedButtonConfig", setupEncoded, inputIdle, checkEncodedBanks,
+      kNoEvent},
+  {"EncodedButtonConfig/click", setupEncoded, inputEncodedClick,
+      checkEncodedBanks, AceButton::kEventClicked},
+  {"LadderButtonConfig", setupLadder, inputIdle, checkLadderBanks, kNoEvent},
+  {"LadderButtonConfig/click", setupLadder, inputLadderClick,
+      checkLadderBanks, AceButton::kEventClicked},
+};
+
+static const uint8_t NUM_SCENARIOS = sizeof(SCENARIOS) / sizeof(Scenario);
+
+/** Number of simulated milliseconds of each run, same as AutoBenchmark. */
+static const unsigned long TICKS = 2000;
+
+static void runScenario(const Scenario& scenario, uint16_t n) {
+  numButtons = n;
+  numEvents = 0;
+  lastEventType = kNoEvent;
+  scenario.setup(n);
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned long t = 0; t < TICKS; t++) {
+    simMillis = t;
+    scenario.input(t);
+    scenario.check();
+  }
+  auto end = std::chrono::steady_clock::now();
+  deleteBanks();
+
+  double elapsedNanos = std::chrono::duration<double, std::nano>(
+      end - start).count();
+  double checks = (double) TICKS * n;
+  double eventsPerSec = (elapsedNanos > 0)
+      ? numEvents * 1e9 / elapsedNanos : 0;
+  bool ok = lastEventType == scenario.expectedEventType;
+
+  SERIAL_PORT_MONITOR.print(scenario.name);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(n);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(TICKS);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print((unsigned long) checks);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(numEvents);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(elapsedNanos / checks, 2);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(eventsPerSec, 0);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.println(ok ? F("ok") : F("ERROR"));
+}
+
+//-----------------------------------------------------------------------------
+
+void setup() {
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready
+
+  configure(buttonConfig);
+  configure(buttonConfigFast8);
+  configure(encoded4To2ButtonConfig);
+  configure(encoded8To3ButtonConfig);
+}
+
+void loop() {
+  SERIAL_PORT_MONITOR.println(
+    F("scenario,buttons,ticks,checks,events,ns_per_check,events_per_sec,"
+      "status"));
+  for (uint8_t s = 0; s < NUM_SCENARIOS; s++) {
+    for (uint8_t i = 0; i < NUM_SIZES; i++) {
+      runScenario(SCENARIOS[s], SIZES[i]);
+    }
+  }
+  exit(0);
+}
@@ -0,0 +1,402 @@
+/*
+ * A deterministic benchmark which runs natively on Linux using EpoxyDuino
+ * (https://github.com/bxparks/EpoxyDuino). Instead of measuring the wall time
+ * like HostBenchmark, it counts the user-space instructions retired by the CPU,
+ * using the hardware performance counters of the Linux perf_event_open(2)
+ * system call. The instruction count of a given binary does not depend on the
+ * load of the machine or on its clock frequency, so the results are
+ * reproducible to within a few instructions, and can be used to detect
+ * performance regressions in a continuous integration pipeline.
+ *
+ * The library is compiled with ACE_BUTTON_PROFILE=1 (see the Makefile), which
+ * calls profileEnter() and profileExit() around the following functions:
+ *
+ *  * AceButton::checkDebounced()
+ *  * AceButton::checkEvent()
+ *  * AceButton::checkReleased()
+ *  * ButtonConfig::dispatchEvent() (called by AceButton::handleEvent())
+ *
+ * The instructions are attributed to each of those functions, as well as to
+ * the whole AceButton::check(). The cost of the hooks themselves is
+ * calibrated at startup and subtracted. The results are printed as CSV:
+ *
+ * @verbatim
+ * scenario,function,calls,inclusive,exclusive,inclusive_per_call,exclusive_per_call,unit,status
+ * idle,check,2000,...,instructions,ok
+ * idle,checkDebounced,0,...,instructions,ok
+ * ...
+ * @endverbatim
+ *
+ * where:
+ *
+ *  * calls: number of calls of the function
+ *  * inclusive: instructions in the function and the functions it calls
+ *  * exclusive: inclusive minus the other profiled functions called by it
+ *  * unit: 'instructions', or 'ns' if the performance counters are not
+ *    available (e.g. in a virtual machine, or if
+ *    /proc/sys/kernel/perf_event_paranoid is greater than 2), in which case
+ *    the thread CPU time is used instead, which is NOT deterministic
+ *  * status: 'ok', 'unstable' if 2 identical runs did not produce the same
+ *    counts, or 'ERROR' if the last event was not the expected one
+ *
+ * Depends on:
+ *
+ *  * https://github.com/bxparks/AceButton
+ *  * https://github.com/bxparks/EpoxyDuino
+ */
+
+#include <stdlib.h> // exit()
+#include <string.h> // memset()
+#include <time.h> // clock_gettime()
+#include <Arduino.h>
+#include <AceButton.h>
+#include <ace_button/ProfileHooks.h>
+
+#if ! defined(EPOXY_DUINO)
+  #error This benchmark runs only on EpoxyDuino
+#endif
+
+#if ! ACE_BUTTON_PROFILE
+  #error This benchmark requires ACE_BUTTON_PROFILE=1
+#endif
+
+#if defined(__linux__)
+  #include <unistd.h> // read(), syscall()
+  #include <sys/syscall.h> // SYS_perf_event_open
+  #include <linux/perf_event.h>
+#endif
+
+using namespace ace_button;
+
+//-----------------------------------------------------------------------------
+// Instruction counter
+//-----------------------------------------------------------------------------
+
+/** File descriptor of the perf event counter, or -1 if not available. */
+static int counterFd = -1;
+
+/** Open the counter of user-space instructions of this thread. */
+static void openCounter() {
+#if defined(__linux__)
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  counterFd = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/**
+ * Return the number of instructions retired so far, or the thread CPU time in
+ * nanoseconds if the instruction counter is not available.
+ */
+static uint64_t readCounter() {
+#if defined(__linux__)
+  if (counterFd >= 0) {
+    uint64_t count;
+    if (read(counterFd, &count, sizeof(count)) == sizeof(count)) return count;
+  }
+#endif
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+// Profiling hooks
+//-----------------------------------------------------------------------------
+
+/** Pseudo function for the whole AceButton::check(). */
+static const uint8_t kProfileCheck = kNumProfiledFunctions;
+
+/** Pseudo function used for calibration. */
+static const uint8_t kProfileCalibrate = kNumProfiledFunctions + 1;
+
+static const uint8_t NUM_COUNTERS = kNumProfiledFunctions + 2;
+
+static const char* const FUNCTION_NAMES[NUM_COUNTERS] = {
+  "checkDebounced",
+  "checkEvent",
+  "checkReleased",
+  "dispatchEvent",
+  "check",
+  "calibrate",
+};
+
+/** Accumulated counts of a profiled function. */
+struct Stats {
+  uint32_t calls;
+  uint64_t inclusive;
+  uint64_t exclusive;
+};
+
+/** An active call of a profiled function. */
+struct Frame {
+  uint64_t start;
+
+  /** Counts of the hooks of the nested calls, to be subtracted. */
+  uint64_t overhead;
+
+  /** Inclusive counts of the nested calls. */
+  uint64_t nested;
+
+  uint8_t function;
+};
+
+static const uint8_t MAX_DEPTH = 8;
+static Frame frames[MAX_DEPTH];
+static uint8_t depth;
+static Stats stats[NUM_COUNTERS];
+
+/** Raw counts of an empty scope, i.e. the cost of reading the counter. */
+static uint64_t scopeCost;
+
+/** Counts added to the enclosing scope by a nested empty scope. */
+static uint64_t nestedCost;
+
+/** Raw counts of the last scope, used for calibration. */
+static uint64_t lastRaw;
+
+namespace ace_button {
+
+void profileEnter(uint8_t function) {
+  Frame& frame = frames[depth++];
+  frame.function = function;
+  frame.overhead = 0;
+  frame.nested = 0;
+  frame.start = readCounter(); // last, to exclude the code above
+}
+
+void profileExit(uint8_t function) {
+  uint64_t end = readCounter(); // first, to exclude the code below
+  Frame& frame = frames[--depth];
+  if (frame.function != function) {
+    SERIAL_PORT_MONITOR.println(F("ERROR: unbalanced profile hooks"));
+    exit(1);
+  }
+
+  lastRaw = end - frame.start;
+  int64_t inclusive = (int64_t) lastRaw - scopeCost - frame.overhead;
+  if (inclusive < 0) inclusive = 0;
+  int64_t exclusive = inclusive - (int64_t) frame.nested;
+  if (exclusive < 0) exclusive = 0;
+
+  Stats& s = stats[function];
+  s.calls++;
+  s.inclusive += inclusive;
+  s.exclusive += exclusive;
+
+  if (depth > 0) {
+    Frame& parent = frames[depth - 1];
+    parent.overhead += frame.overhead + nestedCost;
+    parent.nested += inclusive;
+  }
+}
+
+}
+
+/**
+ * Measure the cost of an empty scope, and the extra cost of a nested empty
+ * scope. Use the minimum of several samples, which removes the noise when the
+ * fallback clock is used.
+ */
+static void calibrate() {
+  uint64_t minEmpty = UINT64_MAX;
+  uint64_t minNested = UINT64_MAX;
+  for (uint16_t i = 0; i < 1000; i++) {
+    {
+      internal::ProfileScope scope(kProfileCalibrate);
+    }
+    if (lastRaw < minEmpty) minEmpty = lastRaw;
+
+    {
+      internal::ProfileScope outer(kProfileCalibrate);
+      {
+        internal::ProfileScope inner(kProfileCalibrate);
+      }
+    }
+    if (lastRaw < minNested) minNested = lastRaw;
+  }
+  // The calibration scopes above ran with scopeCost = nestedCost = 0, so
+  // lastRaw holds the raw counts.
+  scopeCost = minEmpty;
+  nestedCost = (minNested > minEmpty) ? minNested - minEmpty : 0;
+}
+
+//-----------------------------------------------------------------------------
+// Simulated environment and scenarios
+//-----------------------------------------------------------------------------
+
+/** The simulated clock, in milliseconds. */
+static unsigned long simMillis;
+
+/** Button state returned by BenchmarkButtonConfig::readButton(). */
+static int simButtonState = HIGH;
+
+/** A ButtonConfig whose clock and button are simulated. */
+class BenchmarkButtonConfig: public ButtonConfig {
+  public:
+    unsigned long getClock() override { return simMillis; }
+    int readButton(PinType /*pin*/) override { return simButtonState; }
+};
+
+static BenchmarkButtonConfig buttonConfig;
+static AceButton button(&buttonConfig);
+
+static uint8_t lastEventType;
+
+static void handleEvent(AceButton* /*button*/, uint8_t eventType,
+    uint8_t /*buttonState*/) {
+  lastEventType = eventType;
+}
+
+// Input scripts, using the same timelines as AutoBenchmark.
+
+static void inputIdle(unsigned long /*t*/) {}
+
+static void inputPressRelease(unsigned long t) {
+  simButtonState = (100 <= t && t < 1000) ? LOW : HIGH;
+}
+
+static void inputClick(unsigned long t) {
+  simButtonState = (100 <= t && t < 200) ? LOW : HIGH;
+}
+
+static void inputDoubleClick(unsigned long t) {
+  simButtonState = ((100 <= t && t < 200) || (300 <= t && t < 400))
+      ? LOW : HIGH;
+}
+
+static void inputLongPress(unsigned long t) {
+  simButtonState = (100 <= t) ? LOW : HIGH;
+}
+
+/** Features of the config, on top of the default kFeatureClick. */
+static const uint16_t FEATURES_ALL = ButtonConfig::kFeatureClick
+    | ButtonConfig::kFeatureDoubleClick
+    | ButtonConfig::kFeatureLongPress
+    | ButtonConfig::kFeatureRepeatPress
+    | ButtonConfig::kFeatureSuppressAll;
+
+static const uint16_t FEATURES_POSTPONED = ButtonConfig::kFeatureClick
+    | ButtonConfig::kFeatureDoubleClick
+    | ButtonConfig::kFeatureSuppressClickBeforeDoubleClick;
+
+static const uint8_t kNoEvent = 0xFF;
+
+struct Scenario {
+  const char* name;
+  void (*input)(unsigned long t);
+  uint16_t features;
+
+  /** Expected last event type, or kNoEvent if no event is expected. */
+  uint8_t expectedEventType;
+};
+
+static const Scenario SCENARIOS[] = {
+  {"idle", inputIdle, FEATURES_ALL, kNoEvent},
+  {"press/release", inputPressRelease, FEATURES_ALL,
+      AceButton::kEventReleased},
+  {"click", inputClick, FEATURES_ALL, AceButton::kEventClicked},
+  {"double_click", inputDoubleClick, FEATURES_ALL,
+      AceButton::kEventDoubleClicked},
+  {"long_press/repeat_press", inputLongPress, FEATURES_ALL,
+      AceButton::kEventRepeatPressed},
+  {"postponed_click", inputClick, FEATURES_POSTPONED,
+      AceButton::kEventClicked},
+};
+
+static const uint8_t NUM_SCENARIOS = sizeof(SCENARIOS) / sizeof(Scenario);
+
+/** Number of simulated milliseconds of each run, same as AutoBenchmark. */
+static const unsigned long TICKS = 2000;
+
+/** Run the scenario from a fresh button, and collect its stats. */
+static void runScenario(const Scenario& scenario) {
+  simMillis = 0;
+  simButtonState = HIGH;
+  lastEventType = kNoEvent;
+  buttonConfig.clearFeature(0xFFFF);
+  buttonConfig.setFeature(scenario.features);
+  button.init(&buttonConfig, 0);
+  memset(stats, 0, sizeof(stats));
+
+  for (unsigned long t = 0; t < TICKS; t++) {
+    simMillis = t;
+    scenario.input(t);
+
+    internal::ProfileScope scope(kProfileCheck);
+    button.check();
+  }
+}
+
+static void printStats(const Scenario& scenario, uint8_t function,
+    const Stats& s, const char* status) {
+  SERIAL_PORT_MONITOR.print(scenario.name);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(FUNCTION_NAMES[function]);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(s.calls);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print((unsigned long) s.inclusive);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print((unsigned long) s.exclusive);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(s.calls ? (double) s.inclusive / s.calls : 0, 2);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(s.calls ? (double) s.exclusive / s.calls : 0, 2);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(counterFd >= 0 ? F("instructions") : F("ns"));
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.println(status);
+}
+
+/**
+ * Run the scenario twice, and print the stats of the second run. The first
+ * run warms up the caches and resolves the dynamic symbols, and is used to
+ * verify that the counts are reproducible.
+ */
+static void benchmarkScenario(const Scenario& scenario) {
+  Stats first[NUM_COUNTERS];
+  runScenario(scenario);
+  memcpy(first, stats, sizeof(stats));
+  runScenario(scenario);
+
+  const char* status;
+  if (lastEventType != scenario.expectedEventType) {
+    status = "ERROR";
+  } else if (counterFd >= 0 && memcmp(first, stats, sizeof(stats)) != 0) {
+    status = "unstable";
+  } else {
+    status = "ok";
+  }
+
+  printStats(scenario, kProfileCheck, stats[kProfileCheck], status);
+  for (uint8_t f = 0; f < kNumProfiledFunctions; f++) {
+    printStats(scenario, f, stats[f], status);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+void setup() {
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready
+
+  buttonConfig.setEventHandler(handleEvent);
+  openCounter();
+  calibrate();
+}
+
+void loop() {
+  SERIAL_PORT_MONITOR.println(
+    F("scenario,function,calls,inclusive,exclusive,inclusive_per_call,"
+      "exclusive_per_call,unit,status"));
+  for (uint8_t s = 0; s < NUM_SCENARIOS; s++) {
+    benchmarkScenario(SCENARIOS[s]);
+  }
+  exit(0);
+}
@@ -0,0 +1,261 @@
+#!/bin/bash
+#
+# Shell script that compiles MemoryBenchmark.ino for each FEATURE on the local
+# machine, without the Arduino IDE or a board, and collects the flash and
+# static RAM usage, the size of each symbol of the AceButton library, and the
+# sizeof() of each ButtonConfig class.
+#
+# Usage: collect_host.sh {host|avr}
+#
+#   host: compiles with the host compiler using EpoxyDuino ('make'), which is
+#       expected to be installed as a sibling project of AceButton.
+#   avr: compiles with 'avr-g++' for an ATmega328P (Nano) using the AVR core of
+#       the Arduino IDE, found in $ARDUINO_AVR_DIR, or by default in the latest
+#       version under ~/.arduino15/packages/arduino/hardware/avr/. The
+#       ButtonConfigFast features require the digitalWriteFast library in
+#       $DIGITAL_WRITE_FAST_DIR (default: ../../../digitalWriteFast).
+#
+# Creates the following files, where {target} is 'host' or 'avr':
+#
+#   {target}.txt: same format as collect.sh, so that it can be formatted using
+#       generate_table.awk. The max_flash and max_ram are always -1:
+#
+#       FEATURE flash max_flash ram max_ram
+#       0 aa -1 cc -1
+#       ...
+#
+#   {target}_symbols.txt: size of each symbol in the 'ace_button' namespace,
+#       one per line, sorted by decreasing size within each feature:
+#
+#       FEATURE size type symbol
+#
+#   {target}_sizeof.txt: sizeof() of each class of the library:
+#
+#       class size
+
+set -eu
+
+PROGRAM_NAME='MemoryBenchmark.ino'
+NUM_FEATURES=9  # excluding FEATURE_BASELINE
+SRC_DIR='../../src'
+EPOXY_DUINO_DIR=${EPOXY_DUINO_DIR:-'../../../EpoxyDuino'}
+DIGITAL_WRITE_FAST_DIR=${DIGITAL_WRITE_FAST_DIR:-'../../../digitalWriteFast'}
+HOST_GC_FLAGS='-ffunction-sections -fdata-sections -Wl,--gc-sections'
+temp_dir=
+
+function usage() {
+    echo 'Usage: collect_host.sh {host|avr}'
+    exit 1
+}
+
+function cleanup() {
+    if [[ "$temp_dir" != '' ]]; then
+        rm -rf $temp_dir
+    fi
+    sed -i -e "s/#define FEATURE [0-9]*/#define FEATURE 0/" $PROGRAM_NAME
+}
+
+# Print the sizeof() of each class, using the symbol sizes of arrays whose
+# lengths are the sizeof() of the classes, so that the program does not need
+# to be linked or run on the target.
+# Usage: collect_sizeof $compiler $nm $result_file [flags...]
+function collect_sizeof() {
+    local compiler=$1
+    local nm=$2
+    local result_file=$3
+    shift 3
+
+    cat > $temp_dir/sizeof.cpp <<'END'
+#include <Arduino.h>
+#include <AceButton.h>
+#if defined(__has_include)
+  #if __has_include(<digitalWriteFast.h>)
+    #include <digitalWriteFast.h>
+    #include <ace_button/fast/ButtonConfigFast.h>
+    #define HAS_DIGITAL_WRITE_FAST 1
+  #endif
+#endif
+
+using namespace ace_button;
+
+#define SIZEOF(name, ...) extern char sizeof_##name[sizeof(__VA_ARGS__)]; \
+    char sizeof_##name[sizeof(__VA_ARGS__)]
+
+SIZEOF(AceButton, AceButton);
+SIZEOF(ButtonConfig, ButtonConfig);
+SIZEOF(Encoded4To2ButtonConfig, Encoded4To2ButtonConfig);
+SIZEOF(Encoded8To3ButtonConfig, Encoded8To3ButtonConfig);
+SIZEOF(EncodedButtonConfig, EncodedButtonConfig);
+SIZEOF(EncodedButtonConfigN_7, EncodedButtonConfigN<7>);
+SIZEOF(LadderButtonConfig, LadderButtonConfig);
+SIZEOF(LadderButtonConfigN_7, LadderButtonConfigN<7>);
+SIZEOF(VirtualPinDebouncer, VirtualPinDebouncer);
+#if defined(HAS_DIGITAL_WRITE_FAST)
+SIZEOF(ButtonConfigFast_1, ButtonConfigFast<2>);
+SIZEOF(ButtonConfigFast_2, ButtonConfigFast<2, 3>);
+SIZEOF(ButtonConfigFast_3, ButtonConfigFast<2, 3, 4>);
+#endif
+END
+
+    $compiler -c "$@" -o $temp_dir/sizeof.o $temp_dir/sizeof.cpp
+    echo 'class size' > $result_file
+    $nm -S -t d $temp_dir/sizeof.o \
+        | awk '$4 ~ /^sizeof_/ {
+            name = substr($4, 8)
+            sub(/_7$/, "<7>", name)
+            sub(/_1$/, "<1 pin>", name)
+            sub(/_2$/, "<2 pins>", name)
+            sub(/_3$/, "<3 pins>", name)
+            printf("%s %d\n", name, $2)
+        }' \
+        | sort >> $result_file
+}
+
+# Append the symbols of the ace_button namespace to the symbols file.
+# Usage: extract_symbols $nm $binary $feature $symbols_file
+function extract_symbols() {
+    local nm=$1
+    local binary=$2
+    local feature=$3
+    local symbols_file=$4
+
+    $nm -C -S -t d --size-sort $binary \
+        | awk -v feature=$feature '
+            NF >= 4 && $0 ~ /ace_button::/ {
+                name = $4
+                for (i = 5; i <= NF; i++) name = name " " $i
+                printf("%s %d %s %s\n", feature, $2, $3, name)
+            }' \
+        | sort -k2,2nr >> $symbols_file
+}
+
+function collect_host() {
+    local result_file=host.txt
+    local symbols_file=host_symbols.txt
+
+    make clean > /dev/null
+    echo 'FEATURE flash max_flash ram max_ram' > $result_file
+    echo 'FEATURE size type symbol' > $symbols_file
+    for feature in $(seq 0 $NUM_FEATURES); do
+        echo "Collecting host memory usage for FEATURE $feature"
+        sed -i -e "s/#define FEATURE [0-9]*/#define FEATURE $feature/" \
+            $PROGRAM_NAME
+
+        # Remove the unused functions, like the linker of the Arduino IDE.
+        if ! make EXTRA_CXXFLAGS="$HOST_GC_FLAGS" > $temp_dir/make.out 2>&1
+        then
+            if grep -q 'Unsupported FEATURE' $temp_dir/make.out; then
+                echo $feature -1 -1 -1 -1 >> $result_file
+                continue
+            fi
+            cat $temp_dir/make.out
+            exit 1
+        fi
+
+        # Berkeley format: text data bss dec hex filename
+        size MemoryBenchmark.out | awk -v feature=$feature 'NR == 2 {
+            print feature, $1 + $2, -1, $2 + $3, -1
+        }' >> $result_file
+        extract_symbols nm MemoryBenchmark.out $feature $symbols_file
+    done
+
+    collect_sizeof "${CXX:-g++}" nm host_sizeof.txt \
+        -std=gnu++11 -DEPOXY_DUINO \
+        -I$EPOXY_DUINO_DIR/cores/epoxy \
+        -I$EPOXY_DUINO_DIR/libraries/EpoxyMockDigitalWriteFast \
+        -I$SRC_DIR
+}
+
+# Compile the Arduino AVR core once into core.a.
+function build_avr_core() {
+    local core_dir=$1
+    local flags=("${@:2}")
+
+    for f in $core_dir/*.c; do
+        avr-gcc -c -std=gnu11 "${flags[@]}" -o $temp_dir/core/$(basename $f).o $f
+    done
+    for f in $core_dir/*.cpp; do
+        avr-g++ -c -std=gnu++11 -fno-exceptions -fno-threadsafe-statics \
+            "${flags[@]}" -o $temp_dir/core/$(basename $f).o $f
+    done
+    for f in $core_dir/*.S; do
+        avr-gcc -c -x assembler-with-cpp "${flags[@]}" \
+            -o $temp_dir/core/$(basename $f).o $f
+    done
+    avr-gcc-ar rcs $temp_dir/core.a $temp_dir/core/*.o
+}
+
+function collect_avr() {
+    local result_file=avr.txt
+    local symbols_file=avr_symbols.txt
+    local avr_dir=${ARDUINO_AVR_DIR:-$(ls -d \
+        ~/.arduino15/packages/arduino/hardware/avr/* 2> /dev/null \
+        | sort -V | tail -1)}
+
+    if ! command -v avr-g++ > /dev/null; then
+        echo "avr-g++ not found, skipping AVR"
+        return
+    fi
+    if [[ "$avr_dir" == '' || ! -d "$avr_dir/cores/arduino" ]]; then
+        echo "Arduino AVR core not found, set ARDUINO_AVR_DIR, skipping AVR"
+        return
+    fi
+
+    local flags=(-g -Os -w -ffunction-sections -fdata-sections -flto
+        -mmcu=atmega328p -DF_CPU=16000000L -DARDUINO=10819
+        -DARDUINO_AVR_NANO -DARDUINO_ARCH_AVR
+        -I$avr_dir/cores/arduino -I$avr_dir/variants/eightanaloginputs)
+    local lib_flags=(-I$SRC_DIR)
+    if [[ -d $DIGITAL_WRITE_FAST_DIR ]]; then
+        lib_flags+=(-I$DIGITAL_WRITE_FAST_DIR)
+    fi
+    local cxx_flags=(-std=gnu++11 -fpermissive -fno-exceptions
+        -fno-threadsafe-statics "${flags[@]}" "${lib_flags[@]}")
+
+    echo "Compiling Arduino AVR core in $avr_dir"
+    mkdir -p $temp_dir/core
+    build_avr_core $avr_dir/cores/arduino "${flags[@]}"
+
+    echo 'FEATURE flash max_flash ram max_ram' > $result_file
+    echo 'FEATURE size type symbol' > $symbols_file
+    for feature in $(seq 0 $NUM_FEATURES); do
+        echo "Collecting AVR memory usage for FEATURE $feature"
+        sed -e "s/#define FEATURE [0-9]*/#define FEATURE $feature/" \
+            $PROGRAM_NAME > $temp_dir/MemoryBenchmark.cpp
+
+        if ! avr-g++ "${cxx_flags[@]}" -Wl,--gc-sections -fuse-linker-plugin \
+                -o $temp_dir/MemoryBenchmark.elf \
+                $temp_dir/MemoryBenchmark.cpp \
+                $(find $SRC_DIR -name '*.cpp') \
+                $temp_dir/core.a -lm > $temp_dir/make.out 2>&1; then
+            # Unsupported FEATURE, or missing digitalWriteFast library.
+            echo $feature -1 -1 -1 -1 >> $result_file
+            grep -m 1 'error' $temp_dir/make.out || true
+            continue
+        fi
+
+        avr-size -A $temp_dir/MemoryBenchmark.elf | awk -v feature=$feature '
+            $1 == ".text" { text = $2 }
+            $1 == ".data" { data = $2 }
+            $1 == ".bss" { bss = $2 }
+            END { print feature, text + data, -1, data + bss, -1 }
+        ' >> $result_file
+        extract_symbols avr-nm $temp_dir/MemoryBenchmark.elf $feature \
+            $symbols_file
+    done
+
+    collect_sizeof avr-g++ avr-nm avr_sizeof.txt "${cxx_flags[@]}" -fno-lto
+}
+
+trap "cleanup" EXIT
+
+if [[ $# < 1 ]]; then
+    usage
+fi
+
+temp_dir=$(mktemp -d /tmp/memory_benchmark.host.XXXXXX)
+case $1 in
+    host) collect_host ;;
+    avr) collect_avr ;;
+    *) usage ;;
+esac
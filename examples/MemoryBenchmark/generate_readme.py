@@ -80,6 +80,38 @@ will be invoked by the following command:
 $ make README.md
 ```
 
+## Collecting Without a Board
+
+The `collect_host.sh` script compiles each `FEATURE` on the local machine,
+without the Arduino IDE, AUniter, or a board. This allows a change in the
+memory consumption to be detected before the full `make benchmarks`:
+
+```
+$ make host.txt  # host compiler, using EpoxyDuino
+$ make avr.txt   # avr-g++, if available, for an ATmega328P
+```
+
+Each target produces 3 files:
+
+* `host.txt` (or `avr.txt`): the flash and static RAM usage of each
+  `FEATURE`, in the same format as `nano.txt`, so that it can be formatted
+  with `./generate_table.awk < host.txt`
+* `host_symbols.txt` (or `avr_symbols.txt`): the size of each symbol in the
+  `ace_button` namespace for each `FEATURE`
+* `host_sizeof.txt` (or `avr_sizeof.txt`): the `sizeof()` of `AceButton` and
+  of each `ButtonConfig` class
+
+The `avr` target requires `avr-g++` on the `PATH` and the Arduino AVR core,
+found under `~/.arduino15/packages/arduino/hardware/avr/` or in the directory
+given by the `ARDUINO_AVR_DIR` environment variable. The `ButtonConfigFast`
+features also require the
+[digitalWriteFast](https://github.com/NicksonYap/digitalWriteFast) library in
+`../../../digitalWriteFast`, or in `DIGITAL_WRITE_FAST_DIR`. The host numbers
+include the EpoxyDuino runtime, so only the differences between the features,
+and between 2 runs of the script, are meaningful. To check a change, save the
+files generated from the reference version, and `diff` them against the files
+generated from the modified version.
+
 ## Functionality
 
 * Baseline: A program that does (almost) nothing
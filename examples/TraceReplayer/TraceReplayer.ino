@@ -0,0 +1,365 @@
+/*
+ * A host tool which replays an input trace, a stream of (time, pin, level)
+ * records in the binary format of src/ace_button/InputTrace.h, through
+ * AceButton::checkState() using the fake clock of TestableButtonConfig. It
+ * runs natively on Linux or MacOS using EpoxyDuino
+ * (https://github.com/bxparks/EpoxyDuino), at full CPU speed, so that hours of
+ * input captured on a device can be replayed in seconds to reproduce a bug
+ * report, or to compare the events generated by 2 versions of the library.
+ *
+ * Usage:
+ *
+ * @verbatim
+ * $ ./TraceReplayer.out replay [--poll ms] [--released HIGH|LOW]
+ *       [--features hex] [--tail ms] [--quiet] trace.bin
+ * $ ./TraceReplayer.out import [--pins pin,...] capture.csv trace.bin
+ * $ ./TraceReplayer.out dump trace.bin
+ * @endverbatim
+ *
+ *  * replay: creates one AceButton per pin found in the trace, and calls
+ *    checkState() on each of them every '--poll' milliseconds (default 5),
+ *    from the first record until '--tail' milliseconds (default 2000) after
+ *    the last one. The buttons share a ButtonConfig with the given feature
+ *    flags (default: Click, DoubleClick, LongPress and RepeatPress). Prints
+ *    the events as CSV (time,pin,event,state), unless '--quiet' is given,
+ *    followed by a summary in '#' comment lines.
+ *  * import: converts the CSV export of a logic analyzer (e.g. Saleae Logic,
+ *    or sigrok/PulseView) into a binary trace. The first column is the time,
+ *    in seconds unless the header says '[ms]', '[us]' or '[ns]'. The other
+ *    columns are the levels (0 or 1) of the channels, which are mapped to the
+ *    pins given by '--pins', or to pin 0, 1, 2, ... by default. Lines starting
+ *    with ';' or '#' are ignored.
+ *  * dump: prints the records of a binary trace as CSV (time,pin,level).
+ *
+ * Depends on:
+ *
+ *  * https://github.com/bxparks/AceButton
+ *  * https://github.com/bxparks/EpoxyDuino
+ */
+
+#include <stdio.h> // fopen(), fprintf()
+#include <stdlib.h> // exit(), strtoul(), strtod()
+#include <string.h> // strcmp()
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <AceButton.h>
+#include <ace_button/InputTrace.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+
+#if ! defined(EPOXY_DUINO)
+  #error This tool runs only on EpoxyDuino
+#endif
+
+using namespace ace_button;
+using ace_button::testing::TestableButtonConfig;
+
+//-----------------------------------------------------------------------------
+
+static void usage() {
+  fprintf(stderr,
+      "Usage:\n"
+      "  TraceReplayer.out replay [--poll ms] [--released HIGH|LOW]\n"
+      "      [--features hex] [--tail ms] [--quiet] trace.bin\n"
+      "  TraceReplayer.out import [--pins pin,...] capture.csv trace.bin\n"
+      "  TraceReplayer.out dump trace.bin\n");
+  exit(1);
+}
+
+static void fail(const char* message, const char* arg) {
+  fprintf(stderr, "Error: %s: %s\n", message, arg);
+  exit(1);
+}
+
+/** Read the whole file into 'data'. */
+static void readFile(const char* path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) fail("Unable to open", path);
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + n);
+  }
+  fclose(file);
+}
+
+/** Read all the records of the binary trace in 'path'. */
+static void readTrace(const char* path, std::vector<InputEvent>& events) {
+  std::vector<uint8_t> data;
+  readFile(path, data);
+  InputTraceReader reader(data.data(), data.size());
+  if (! reader.isValid()) fail("Not an input trace", path);
+  InputEvent event;
+  while (reader.next(event)) events.push_back(event);
+
+  // Do not replay a partial trace, e.g. whose pins were truncated to the
+  // wrong buttons.
+  if (! reader.isEnd()) {
+    fail("Truncated trace, or pin above 255 without ACE_BUTTON_WIDE_PINS",
+        path);
+  }
+}
+
+/** Return 'pin' as a PinType, or fail if it does not fit. */
+static PinType toPin(unsigned long pin, const char* arg) {
+  if (pin != (PinType) pin) {
+    fail("Pin above 255 requires ACE_BUTTON_WIDE_PINS", arg);
+  }
+  return (PinType) pin;
+}
+
+//-----------------------------------------------------------------------------
+
+static TestableButtonConfig buttonConfig;
+static bool quiet = false;
+static unsigned long numEvents = 0;
+
+static void handleEvent(AceButton* button, uint8_t eventType,
+    uint8_t buttonState) {
+  numEvents++;
+  if (quiet) return;
+  SERIAL_PORT_MONITOR.print(buttonConfig.getClock());
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(button->getPin());
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(AceButton::eventName(eventType));
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.println(buttonState);
+}
+
+static void replay(int argc, const char* const* argv) {
+  uint32_t poll = 5;
+  uint32_t tail = 2000;
+  uint8_t releasedState = HIGH;
+  uint32_t features = ButtonConfig::kFeatureClick
+      | ButtonConfig::kFeatureDoubleClick
+      | ButtonConfig::kFeatureLongPress
+      | ButtonConfig::kFeatureRepeatPress;
+  const char* path = nullptr;
+
+  for (int i = 2; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (strcmp(arg, "--poll") == 0 && hasValue) {
+      poll = strtoul(argv[++i], nullptr, 10);
+      if (poll == 0) fail("Invalid poll interval", argv[i]);
+    } else if (strcmp(arg, "--tail") == 0 && hasValue) {
+      tail = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(arg, "--released") == 0 && hasValue) {
+      releasedState = (strcmp(argv[++i], "LOW") == 0) ? LOW : HIGH;
+    } else if (strcmp(arg, "--features") == 0 && hasValue) {
+      features = strtoul(argv[++i], nullptr, 16);
+    } else if (strcmp(arg, "--quiet") == 0) {
+      quiet = true;
+    } else if (arg[0] == '-' || path != nullptr) {
+      usage();
+    } else {
+      path = arg;
+    }
+  }
+  if (path == nullptr) usage();
+
+  std::vector<InputEvent> events;
+  readTrace(path, events);
+  if (events.empty()) fail("No records in", path);
+
+  // One button per pin, released until the first record of its pin.
+  std::map<PinType, size_t> indexes;
+  std::vector<std::unique_ptr<AceButton>> buttons;
+  std::vector<uint8_t> levels;
+  for (const InputEvent& event : events) {
+    if (indexes.count(event.pin)) continue;
+    indexes[event.pin] = buttons.size();
+    buttons.emplace_back(new AceButton(
+        &buttonConfig, event.pin, releasedState, (IdType) buttons.size()));
+    levels.push_back(releasedState);
+  }
+
+  buttonConfig.init();
+  buttonConfig.setFeature(features);
+  buttonConfig.setEventHandler(handleEvent);
+  if (! quiet) SERIAL_PORT_MONITOR.println(F("time,pin,event,state"));
+
+  auto startTime = std::chrono::steady_clock::now();
+  uint32_t startMillis = events.front().time;
+  uint32_t endMillis = events.back().time + tail;
+  unsigned long numChecks = 0;
+  size_t next = 0;
+  for (uint32_t now = startMillis; now <= endMillis; now += poll) {
+    while (next < events.size() && events[next].time <= now) {
+      levels[indexes[events[next].pin]] = events[next].level;
+      next++;
+    }
+    buttonConfig.setClock(now);
+    for (size_t i = 0; i < buttons.size(); i++) {
+      buttons[i]->checkState(levels[i]);
+    }
+    numChecks += buttons.size();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - startTime;
+  double wallMillis =
+      std::chrono::duration<double, std::milli>(elapsed).count();
+
+  SERIAL_PORT_MONITOR.print(F("# records="));
+  SERIAL_PORT_MONITOR.print((unsigned long) events.size());
+  SERIAL_PORT_MONITOR.print(F(" buttons="));
+  SERIAL_PORT_MONITOR.print((unsigned long) buttons.size());
+  SERIAL_PORT_MONITOR.print(F(" checks="));
+  SERIAL_PORT_MONITOR.print(numChecks);
+  SERIAL_PORT_MONITOR.print(F(" events="));
+  SERIAL_PORT_MONITOR.println(numEvents);
+  SERIAL_PORT_MONITOR.print(F("# simulated_ms="));
+  SERIAL_PORT_MONITOR.print((unsigned long) (endMillis - startMillis));
+  SERIAL_PORT_MONITOR.print(F(" wall_ms="));
+  SERIAL_PORT_MONITOR.print(wallMillis, 1);
+  SERIAL_PORT_MONITOR.print(F(" speedup="));
+  SERIAL_PORT_MONITOR.println(
+      (endMillis - startMillis) / (wallMillis > 0 ? wallMillis : 1), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+/** Split 'line' at the commas. */
+static void splitFields(const std::string& line,
+    std::vector<std::string>& fields) {
+  fields.clear();
+  size_t start = 0;
+  while (true) {
+    size_t comma = line.find(',', start);
+    fields.push_back(line.substr(start, comma - start));
+    if (comma == std::string::npos) break;
+    start = comma + 1;
+  }
+}
+
+/** Return the number of milliseconds per unit of the time in 'header'. */
+static double timeScale(const std::string& header) {
+  if (header.find("[ms]") != std::string::npos) return 1.0;
+  if (header.find("[us]") != std::string::npos) return 1e-3;
+  if (header.find("[ns]") != std::string::npos) return 1e-6;
+  return 1e3;
+}
+
+static void import(int argc, const char* const* argv) {
+  std::vector<PinType> pins;
+  const char* paths[2] = {nullptr, nullptr};
+  int numPaths = 0;
+
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--pins") == 0 && i + 1 < argc) {
+      const char* s = argv[++i];
+      char* end;
+      do {
+        pins.push_back(toPin(strtoul(s, &end, 10), argv[i]));
+        s = end + 1;
+      } while (*end == ',');
+    } else if (argv[i][0] == '-' || numPaths == 2) {
+      usage();
+    } else {
+      paths[numPaths++] = argv[i];
+    }
+  }
+  if (numPaths != 2) usage();
+
+  FILE* file = fopen(paths[0], "r");
+  if (file == nullptr) fail("Unable to open", paths[0]);
+
+  std::vector<InputEvent> events;
+  std::vector<int> lastLevels;
+  std::vector<std::string> fields;
+  double scale = 1e3;
+  bool hasStartTime = false;
+  double startTime = 0;
+  char buffer[1024];
+  while (fgets(buffer, sizeof(buffer), file)) {
+    std::string line(buffer);
+    while (! line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == ';' || line[0] == '#') continue;
+
+    splitFields(line, fields);
+    char* end;
+    double time = strtod(fields[0].c_str(), &end);
+    if (end == fields[0].c_str()) {
+      // Header line.
+      scale = timeScale(fields[0]);
+      continue;
+    }
+    if (! hasStartTime) {
+      hasStartTime = true;
+      startTime = time;
+      lastLevels.assign(fields.size() - 1, -1);
+    }
+
+    uint32_t millis = (uint32_t) ((time - startTime) * scale);
+    for (size_t c = 1; c < fields.size() && c <= lastLevels.size(); c++) {
+      int level = atoi(fields[c].c_str()) ? HIGH : LOW;
+      if (level == lastLevels[c - 1]) continue;
+      lastLevels[c - 1] = level;
+      PinType pin = (c - 1 < pins.size())
+          ? pins[c - 1] : toPin(c - 1, paths[0]);
+      events.push_back({millis, pin, (uint8_t) level});
+    }
+  }
+  fclose(file);
+
+  std::vector<uint8_t> data(
+      InputTrace::kHeaderSize + events.size() * InputTrace::kMaxRecordSize);
+  InputTraceWriter writer(data.data(), data.size());
+  for (const InputEvent& event : events) {
+    writer.record(event.time, event.pin, event.level);
+  }
+
+  FILE* out = fopen(paths[1], "wb");
+  if (out == nullptr) fail("Unable to create", paths[1]);
+  fwrite(writer.getBuffer(), 1, writer.getSize(), out);
+  fclose(out);
+
+  SERIAL_PORT_MONITOR.print(F("# records="));
+  SERIAL_PORT_MONITOR.print(writer.getNumRecords());
+  SERIAL_PORT_MONITOR.print(F(" bytes="));
+  SERIAL_PORT_MONITOR.println((unsigned long) writer.getSize());
+}
+
+//-----------------------------------------------------------------------------
+
+static void dump(int argc, const char* const* argv) {
+  if (argc != 3) usage();
+  std::vector<InputEvent> events;
+  readTrace(argv[2], events);
+
+  SERIAL_PORT_MONITOR.println(F("time,pin,level"));
+  for (const InputEvent& event : events) {
+    SERIAL_PORT_MONITOR.print(event.time);
+    SERIAL_PORT_MONITOR.print(',');
+    SERIAL_PORT_MONITOR.print(event.pin);
+    SERIAL_PORT_MONITOR.print(',');
+    SERIAL_PORT_MONITOR.println(event.level);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+void setup() {
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready
+}
+
+void loop() {
+  if (epoxy_argc < 2) usage();
+  const char* command = epoxy_argv[1];
+  if (strcmp(command, "replay") == 0) {
+    replay(epoxy_argc, epoxy_argv);
+  } else if (strcmp(command, "import") == 0) {
+    import(epoxy_argc, epoxy_argv);
+  } else if (strcmp(command, "dump") == 0) {
+    dump(epoxy_argc, epoxy_argv);
+  } else {
+    usage();
+  }
+  exit(0);
+}
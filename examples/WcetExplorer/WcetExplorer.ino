@@ -0,0 +1,605 @@
+/*
+ * A host tool which explores the state machine of AceButton to find the worst
+ * case execution time (WCET) of a single AceButton::check(). It runs natively
+ * on Linux using EpoxyDuino (https://github.com/bxparks/EpoxyDuino).
+ *
+ * For every combination of the ButtonConfig feature flags, it performs a
+ * breadth-first search over the reachable states of the button, starting from
+ * a freshly initialized AceButton. A state is identified by the internal
+ * flags of the button (AceButton::getFlags()), its last debounced state, and
+ * the position of each active timer (debouncing, press, click, repeat press,
+ * heart beat) relative to the delays of the ButtonConfig which could expire
+ * next. From each state, the next check() is called with the button either
+ * pressed or released, and with the simulated clock advanced by 0 or 1
+ * millisecond, or to just before or exactly at the expiry of each pending
+ * timer.
+ *
+ * Each check() is traced using the ACE_BUTTON_PROFILE hooks (see
+ * src/ace_button/ProfileHooks.h), which gives the sequence of internal
+ * functions and dispatched events, i.e. the path taken through the state
+ * machine. The cost of each check() is measured in user-space instructions
+ * using perf_event_open(2), or in nanoseconds of thread CPU time if the
+ * performance counters are not available.
+ *
+ * The paths are printed as CSV, sorted by decreasing cost, followed by the
+ * list of paths which dispatch more than one event in a single tick:
+ *
+ * @verbatim
+ * path,events,occurrences,max_cost,unit,features,flags,example
+ * checkDebounced checkEvent checkReleased dispatchEvent(Clicked) ...
+ * ...
+ * # Paths dispatching more than one event in a single tick:
+ * ...
+ * @endverbatim
+ *
+ * where:
+ *
+ *  * path: the profiled functions entered during the check(), in order, with
+ *    the dispatched events in parenthesis. 'idle' if none was entered.
+ *  * events: number of events dispatched by the check()
+ *  * occurrences: number of explored transitions which took this path
+ *  * max_cost: maximum cost of the check() over those transitions
+ *  * unit: 'instructions' or 'ns'
+ *  * features, flags: the feature flags of the ButtonConfig and the flags of
+ *    the AceButton before the most expensive check()
+ *  * example: the sequence of (time:input) checks from a fresh AceButton
+ *    which reproduces the most expensive check(), which is the last one
+ *
+ * Depends on:
+ *
+ *  * https://github.com/bxparks/AceButton
+ *  * https://github.com/bxparks/EpoxyDuino
+ */
+
+#include <stdlib.h> // exit()
+#include <string.h> // memset()
+#include <time.h> // clock_gettime()
+#include <algorithm> // std::sort()
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <AceButton.h>
+#include <ace_button/ProfileHooks.h>
+
+#if ! defined(EPOXY_DUINO)
+  #error This tool runs only on EpoxyDuino
+#endif
+
+#if ! ACE_BUTTON_PROFILE
+  #error This tool requires ACE_BUTTON_PROFILE=1
+#endif
+
+#if defined(__linux__)
+  #include <unistd.h> // read(), syscall()
+  #include <sys/syscall.h> // SYS_perf_event_open
+  #include <linux/perf_event.h>
+#endif
+
+using namespace ace_button;
+
+//-----------------------------------------------------------------------------
+// Instruction counter, same as examples/InstructionBenchmark.
+//-----------------------------------------------------------------------------
+
+/** File descriptor of the perf event counter, or -1 if not available. */
+static int counterFd = -1;
+
+/** Open the counter of user-space instructions of this thread. */
+static void openCounter() {
+#if defined(__linux__)
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  counterFd = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/**
+ * Return the number of instructions retired so far, or the thread CPU time in
+ * nanoseconds if the instruction counter is not available.
+ */
+static uint64_t readCounter() {
+#if defined(__linux__)
+  if (counterFd >= 0) {
+    uint64_t count;
+    if (read(counterFd, &count, sizeof(count)) == sizeof(count)) return count;
+  }
+#endif
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+// Simulated button and tracing
+//-----------------------------------------------------------------------------
+
+/** The simulated clock, in milliseconds. */
+static unsigned long simMillis;
+
+/** Button state returned by ExplorerButtonConfig::readButton(). */
+static uint8_t simButtonState = HIGH;
+
+/** A ButtonConfig whose clock and button are simulated. */
+class ExplorerButtonConfig: public ButtonConfig {
+  public:
+    unsigned long getClock() override { return simMillis; }
+    int readButton(PinType /*pin*/) override { return simButtonState; }
+};
+
+static ExplorerButtonConfig buttonConfig;
+static AceButton button(&buttonConfig);
+
+static const char* const FUNCTION_NAMES[kNumProfiledFunctions] = {
+  "checkDebounced",
+  "checkEvent",
+  "checkReleased",
+  "dispatchEvent",
+};
+
+// Mirrors the private AceButton::kFlag* constants, for display only.
+static const uint16_t kFlagDebouncing = 0x02;
+static const uint16_t kFlagPressed = 0x04;
+static const uint16_t kFlagClicked = 0x08;
+static const uint16_t kFlagRepeatPressed = 0x40;
+static const uint16_t kFlagClickPostponed = 0x80;
+static const uint16_t kFlagHeartRunning = 0x100;
+
+static const char* const FLAG_NAMES[] = {
+  "DefaultReleasedHigh",
+  "Debouncing",
+  "Pressed",
+  "Clicked",
+  "DoubleClicked",
+  "LongPressed",
+  "RepeatPressed",
+  "ClickPostponed",
+  "HeartRunning",
+};
+
+static const uint8_t NUM_FLAG_NAMES = sizeof(FLAG_NAMES) / sizeof(const char*);
+
+/** Record the path of the current check() only when true. */
+static bool recording;
+
+/** Profiled functions and events of the current check(). */
+static std::string tickPath;
+
+/** Number of profile hooks called during the current check(). */
+static uint16_t tickHooks;
+
+static const uint8_t MAX_TICK_EVENTS = 16;
+static uint8_t tickEvents[MAX_TICK_EVENTS];
+static uint8_t numTickEvents;
+
+namespace ace_button {
+
+void profileEnter(uint8_t function) {
+  tickHooks++;
+  if (!recording) return;
+  if (!tickPath.empty()) tickPath += ' ';
+  tickPath += FUNCTION_NAMES[function];
+}
+
+void profileExit(uint8_t /*function*/) {}
+
+}
+
+static void handleEvent(AceButton* /*button*/, uint8_t eventType,
+    uint8_t /*buttonState*/) {
+  if (numTickEvents < MAX_TICK_EVENTS) tickEvents[numTickEvents++] = eventType;
+  if (!recording) return;
+  tickPath += '(';
+  tickPath += (const char*) AceButton::eventName(eventType);
+  tickPath += ')';
+}
+
+/** Raw counts of 2 consecutive readCounter(). */
+static uint64_t counterCost;
+
+/** Counts of a profile hook which does not record. */
+static uint64_t hookCost;
+
+/** Measure the costs subtracted from each check(). */
+static void calibrate() {
+  counterCost = UINT64_MAX;
+  hookCost = UINT64_MAX;
+  for (uint16_t i = 0; i < 1000; i++) {
+    uint64_t start = readCounter();
+    uint64_t end = readCounter();
+    if (end - start < counterCost) counterCost = end - start;
+
+    start = readCounter();
+    {
+      internal::ProfileScope scope(kProfileCheckEvent);
+    }
+    end = readCounter();
+    if (end - start < hookCost) hookCost = end - start;
+  }
+  hookCost = (hookCost > counterCost) ? hookCost - counterCost : 0;
+}
+
+//-----------------------------------------------------------------------------
+// Timers
+//-----------------------------------------------------------------------------
+
+/**
+ * The start times of the timers of the AceButton. They are private to
+ * AceButton, so they are reconstructed from the changes of the flags and from
+ * the dispatched events.
+ */
+struct Timers {
+  uint16_t debounce;
+  uint16_t press;
+  uint16_t click;
+  uint16_t repeat;
+  uint16_t heartBeat;
+};
+
+static Timers timers;
+
+static void updateTimers(uint16_t before, uint16_t after, uint16_t now) {
+  bool rose = false;
+  if (!(before & kFlagDebouncing) && (after & kFlagDebouncing)) {
+    timers.debounce = now;
+  }
+  if (!(before & kFlagHeartRunning) && (after & kFlagHeartRunning)) {
+    timers.heartBeat = now;
+  }
+  if ((!(before & kFlagClicked) && (after & kFlagClicked))
+      || (!(before & kFlagClickPostponed) && (after & kFlagClickPostponed))) {
+    rose = true;
+    timers.click = now;
+  }
+  // A Clicked event which was not postponed is a new click, even if the
+  // Clicked flag was already set.
+  bool postponedFired = (before & kFlagClickPostponed)
+      && !(after & kFlagClickPostponed);
+  for (uint8_t i = 0; i < numTickEvents; i++) {
+    switch (tickEvents[i]) {
+      case AceButton::kEventPressed:
+        timers.press = now;
+        break;
+      case AceButton::kEventRepeatPressed:
+        timers.repeat = now;
+        break;
+      case AceButton::kEventHeartBeat:
+        timers.heartBeat = now;
+        break;
+      case AceButton::kEventClicked:
+        if (!rose && !postponedFired) timers.click = now;
+        break;
+    }
+  }
+}
+
+/** A pending expiry of a timer. */
+struct Deadline {
+  uint16_t remaining;
+  uint8_t id;
+
+  bool operator<(const Deadline& other) const {
+    return remaining < other.remaining
+        || (remaining == other.remaining && id < other.id);
+  }
+};
+
+/**
+ * Append the region of the timer started at 'start' to 'key', i.e. the number
+ * of 'delays' which have expired, and add the delays which have not expired
+ * to 'deadlines'.
+ */
+static void addTimer(std::string& key, std::vector<Deadline>& deadlines,
+    uint8_t id, bool active, uint16_t start, uint16_t now,
+    const uint16_t* delays, uint8_t numDelays) {
+  uint8_t expired = 0;
+  if (active) {
+    uint16_t elapsed = now - start;
+    for (uint8_t i = 0; i < numDelays; i++) {
+      if (elapsed >= delays[i]) {
+        expired++;
+      } else {
+        deadlines.push_back({(uint16_t) (delays[i] - elapsed),
+            (uint8_t) (id * 4 + i)});
+      }
+    }
+  }
+  key += active ? (char) ('0' + expired) : '-';
+}
+
+/**
+ * Return the key which identifies the state of the button, and fill
+ * 'deadlines' with the pending timer expiries, sorted by time.
+ */
+static std::string stateKey(std::vector<Deadline>& deadlines) {
+  uint16_t now = simMillis;
+  uint16_t flags = button.getFlags();
+  const ButtonConfig& c = buttonConfig;
+  const uint16_t debounceDelays[] = {c.getDebounceDelay()};
+  const uint16_t pressDelays[] = {
+    c.getClickDelay(), c.getLongPressDelay(), c.getRepeatPressDelay()
+  };
+  const uint16_t clickDelays[] = {c.getDoubleClickDelay()};
+  const uint16_t repeatDelays[] = {c.getRepeatPressInterval()};
+  const uint16_t heartBeatDelays[] = {c.getHeartBeatInterval()};
+
+  std::string key = std::to_string(flags) + ','
+      + std::to_string(button.getLastButtonState()) + ',';
+  deadlines.clear();
+  addTimer(key, deadlines, 0, flags & kFlagDebouncing, timers.debounce, now,
+      debounceDelays, 1);
+  addTimer(key, deadlines, 1, flags & kFlagPressed, timers.press, now,
+      pressDelays, 3);
+  addTimer(key, deadlines, 2, flags & (kFlagClicked | kFlagClickPostponed),
+      timers.click, now, clickDelays, 1);
+  addTimer(key, deadlines, 3, flags & kFlagRepeatPressed, timers.repeat, now,
+      repeatDelays, 1);
+  addTimer(key, deadlines, 4, flags & kFlagHeartRunning, timers.heartBeat,
+      now, heartBeatDelays, 1);
+
+  // The order in which the pending timers expire is part of the state.
+  std::sort(deadlines.begin(), deadlines.end());
+  key += ',';
+  for (size_t i = 0; i < deadlines.size(); i++) {
+    if (i > 0) {
+      key += (deadlines[i].remaining == deadlines[i - 1].remaining)
+          ? '=' : '<';
+    }
+    key += (char) ('a' + deadlines[i].id);
+  }
+  return key;
+}
+
+//-----------------------------------------------------------------------------
+// Exploration
+//-----------------------------------------------------------------------------
+
+/** One call to check(), after advancing the clock by 'delta'. */
+struct Step {
+  uint16_t delta;
+  uint8_t buttonState;
+};
+
+typedef std::vector<Step> Trace;
+
+/** Worst case of a path through check(). */
+struct PathStats {
+  uint32_t occurrences;
+  uint64_t maxCost;
+  uint8_t events;
+  uint16_t features;
+  uint16_t flags;
+  Trace example;
+};
+
+static std::map<std::string, PathStats> paths;
+static uint32_t numStates;
+static uint32_t numTransitions;
+
+/** Maximum length of a trace, as a safety net against a runaway search. */
+static const uint16_t MAX_TRACE_LENGTH = 64;
+static uint32_t numTruncated;
+
+static void resetButton(uint16_t features) {
+  buttonConfig.clearFeature(0xFFFF);
+  buttonConfig.setFeature(features);
+  button.init(&buttonConfig, 0);
+  simMillis = 0;
+  memset(&timers, 0, sizeof(timers));
+}
+
+/** Advance the clock, call check(), and return its cost. */
+static uint64_t runStep(const Step& step) {
+  simMillis += step.delta;
+  simButtonState = step.buttonState;
+  uint16_t before = button.getFlags();
+  tickHooks = 0;
+  numTickEvents = 0;
+
+  uint64_t start = readCounter();
+  button.check();
+  uint64_t end = readCounter();
+
+  updateTimers(before, button.getFlags(), simMillis);
+  int64_t cost = (int64_t) (end - start) - counterCost - tickHooks * hookCost;
+  return (cost > 0) ? cost : 0;
+}
+
+static void replay(uint16_t features, const Trace& trace) {
+  resetButton(features);
+  for (const Step& step : trace) runStep(step);
+}
+
+/** Return the candidate clock advances from the current state. */
+static std::vector<uint16_t> candidateDeltas(
+    const std::vector<Deadline>& deadlines) {
+  std::set<uint16_t> deltas = {0, 1};
+  for (const Deadline& d : deadlines) {
+    deltas.insert(d.remaining - 1);
+    deltas.insert(d.remaining);
+  }
+  return std::vector<uint16_t>(deltas.begin(), deltas.end());
+}
+
+/**
+ * Apply 'step' to the state reached by 'trace', and record the path taken by
+ * check(). Return the key of the new state.
+ */
+static std::string explore(uint16_t features, const Trace& trace,
+    const Step& step, std::vector<Deadline>& deadlines) {
+  // The cost is not reproducible without the instruction counter, so keep the
+  // minimum of a few runs.
+  uint8_t runs = (counterFd >= 0) ? 1 : 3;
+  uint64_t cost = UINT64_MAX;
+  uint16_t flags = 0;
+  for (uint8_t r = 0; r < runs; r++) {
+    replay(features, trace);
+    flags = button.getFlags();
+    recording = true;
+    tickPath.clear();
+    uint64_t c = runStep(step);
+    recording = false;
+    if (c < cost) cost = c;
+  }
+  numTransitions++;
+
+  const std::string& name = tickPath.empty() ? std::string("idle") : tickPath;
+  PathStats& stats = paths[name];
+  stats.occurrences++;
+  stats.events = numTickEvents;
+  if (stats.occurrences == 1 || cost > stats.maxCost) {
+    stats.maxCost = cost;
+    stats.features = features;
+    stats.flags = flags;
+    stats.example = trace;
+    stats.example.push_back(step);
+  }
+  return stateKey(deadlines);
+}
+
+/** Breadth-first search of the states reachable with the given features. */
+static void exploreFeatures(uint16_t features) {
+  std::set<std::string> visited;
+  std::deque<Trace> queue;
+  std::vector<Deadline> deadlines;
+
+  resetButton(features);
+  visited.insert(stateKey(deadlines));
+  queue.push_back(Trace());
+
+  while (!queue.empty()) {
+    Trace trace = queue.front();
+    queue.pop_front();
+    numStates++;
+
+    replay(features, trace);
+    stateKey(deadlines);
+    std::vector<uint16_t> deltas = candidateDeltas(deadlines);
+
+    for (uint16_t delta : deltas) {
+      for (uint8_t buttonState = LOW; buttonState <= HIGH; buttonState++) {
+        Step step = {delta, buttonState};
+        std::string key = explore(features, trace, step, deadlines);
+        if (visited.insert(key).second) {
+          if (trace.size() >= MAX_TRACE_LENGTH) {
+            numTruncated++;
+            continue;
+          }
+          Trace next = trace;
+          next.push_back(step);
+          queue.push_back(next);
+        }
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Output
+//-----------------------------------------------------------------------------
+
+static void printFlags(uint16_t flags) {
+  bool first = true;
+  for (uint8_t i = 0; i < NUM_FLAG_NAMES; i++) {
+    if (flags & (1 << i)) {
+      if (!first) SERIAL_PORT_MONITOR.print('|');
+      SERIAL_PORT_MONITOR.print(FLAG_NAMES[i]);
+      first = false;
+    }
+  }
+  if (first) SERIAL_PORT_MONITOR.print(F("none"));
+}
+
+static void printTrace(const Trace& trace) {
+  unsigned long t = 0;
+  for (size_t i = 0; i < trace.size(); i++) {
+    t += trace[i].delta;
+    if (i > 0) SERIAL_PORT_MONITOR.print(' ');
+    SERIAL_PORT_MONITOR.print(t);
+    SERIAL_PORT_MONITOR.print(':');
+    SERIAL_PORT_MONITOR.print(trace[i].buttonState == LOW ? 'L' : 'H');
+  }
+}
+
+static void printPath(const std::string& name, const PathStats& stats) {
+  SERIAL_PORT_MONITOR.print(name.c_str());
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(stats.events);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(stats.occurrences);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print((unsigned long) stats.maxCost);
+  SERIAL_PORT_MONITOR.print(',');
+  SERIAL_PORT_MONITOR.print(counterFd >= 0 ? F("instructions") : F("ns"));
+  SERIAL_PORT_MONITOR.print(F(",0x"));
+  SERIAL_PORT_MONITOR.print(stats.features, HEX);
+  SERIAL_PORT_MONITOR.print(',');
+  printFlags(stats.flags);
+  SERIAL_PORT_MONITOR.print(',');
+  printTrace(stats.example);
+  SERIAL_PORT_MONITOR.println();
+}
+
+static bool compareCost(
+    const std::map<std::string, PathStats>::const_iterator& a,
+    const std::map<std::string, PathStats>::const_iterator& b) {
+  return a->second.maxCost > b->second.maxCost;
+}
+
+static void printResults() {
+  std::vector<std::map<std::string, PathStats>::const_iterator> sorted;
+  for (auto it = paths.begin(); it != paths.end(); ++it) sorted.push_back(it);
+  std::stable_sort(sorted.begin(), sorted.end(), compareCost);
+
+  SERIAL_PORT_MONITOR.println(
+      F("path,events,occurrences,max_cost,unit,features,flags,example"));
+  for (const auto& it : sorted) printPath(it->first, it->second);
+
+  SERIAL_PORT_MONITOR.println(
+      F("# Paths dispatching more than one event in a single tick:"));
+  for (const auto& it : sorted) {
+    if (it->second.events <= 1) continue;
+    SERIAL_PORT_MONITOR.print(F("# "));
+    SERIAL_PORT_MONITOR.println(it->first.c_str());
+  }
+
+  SERIAL_PORT_MONITOR.print(F("# states="));
+  SERIAL_PORT_MONITOR.print(numStates);
+  SERIAL_PORT_MONITOR.print(F(" transitions="));
+  SERIAL_PORT_MONITOR.print(numTransitions);
+  SERIAL_PORT_MONITOR.print(F(" paths="));
+  SERIAL_PORT_MONITOR.print((unsigned long) paths.size());
+  SERIAL_PORT_MONITOR.print(F(" truncated="));
+  SERIAL_PORT_MONITOR.println(numTruncated);
+}
+
+//-----------------------------------------------------------------------------
+
+/** All the feature flags, which happen to be contiguous bits. */
+static const uint16_t NUM_FEATURE_COMBINATIONS =
+    ButtonConfig::kFeatureSpeculativeClick << 1;
+
+void setup() {
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready
+
+  buttonConfig.setEventHandler(handleEvent);
+  openCounter();
+  calibrate();
+}
+
+void loop() {
+  for (uint16_t features = 0; features < NUM_FEATURE_COMBINATIONS;
+      features++) {
+    exploreFeatures(features);
+  }
+  printResults();
+  exit(0);
+}
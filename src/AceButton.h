@@ -42,7 +42,10 @@ SOFTWARE.
 #include "ace_button/Encoded4To2ButtonConfig.h"
 #include "ace_button/EncodedButtonConfig.h"
 #include "ace_button/LadderButtonConfig.h"
+#include "ace_button/OversampledButtonConfig.h"
 #include "ace_button/AceButton.h"
+#include "ace_button/EncodedButtonConfigN.h"
+#include "ace_button/LadderButtonConfigN.h"
 
 // Version format: xxyyzz == "xx.yy.zz"
 #define ACE_BUTTON_VERSION 11001
@@ -23,6 +23,9 @@ SOFTWARE.
 */
 
 #include "AceButton.h"
+#include "ProfileHooks.h"
+#include "TraceHooks.h"
+#include "FlightRecorder.h"
 
 namespace ace_button {
 
@@ -63,6 +66,7 @@ static const char sEventLongPressed[] PROGMEM = "LongPressed";
 static const char sEventRepeatPressed[] PROGMEM = "RepeatPressed";
 static const char sEventLongReleased[] PROGMEM = "LongReleased";
 static const char sEventHeartBeat[] PROGMEM = "HeartBeat";
+static const char sEventClickRetracted[] PROGMEM = "ClickRetracted";
 static const char sEventUnknown[] PROGMEM = "(unknown)";
 
 static const char* const sEventNames[] PROGMEM = {
@@ -74,6 +78,7 @@ static const char* const sEventNames[] PROGMEM = {
   sEventRepeatPressed,
   sEventLongReleased,
   sEventHeartBeat,
+  sEventClickRetracted,
 };
 
 __FlashStringHelper* AceButton::eventName(uint8_t event) {
@@ -85,16 +90,28 @@ __FlashStringHelper* AceButton::eventName(uint8_t event) {
 
 //-----------------------------------------------------------------------------
 
-void AceButton::init(uint8_t pin, uint8_t defaultReleasedState, uint8_t id) {
+void AceButton::init(PinType pin, uint8_t defaultReleasedState, IdType id) {
   mPin = pin;
   mId = id;
   mFlags = 0;
   mLastButtonState = kButtonStateUnknown;
+#if ACE_BUTTON_DEBOUNCE_SAMPLED
+  mDebounceSamples = 0;
+#endif
+#if ACE_BUTTON_BOUNCE_STATS
+  mBounceMeter.reset();
+#endif
+#if ACE_BUTTON_LATENCY
+  mPressEdgeTime = 0;
+#endif
+#if ACE_BUTTON_CLICK_TUNER
+  mLastClickReleaseTime = 0;
+#endif
   setDefaultReleasedState(defaultReleasedState);
 }
 
-void AceButton::init(ButtonConfig* buttonConfig, uint8_t pin,
-    uint8_t defaultReleasedState, uint8_t id) {
+void AceButton::init(ButtonConfig* buttonConfig, PinType pin,
+    uint8_t defaultReleasedState, IdType id) {
   mButtonConfig = buttonConfig;
   init(pin, defaultReleasedState, id);
 }
@@ -114,22 +131,34 @@ uint8_t AceButton::getDefaultReleasedState() const {
 // NOTE: It would be interesting to rewrite the check() method using a Finite
 // State Machine.
 void AceButton::check() {
+  ACE_BUTTON_STATS_INCREMENT(mButtonConfig, reads);
   uint8_t buttonState = mButtonConfig->readButton(mPin);
   checkState(buttonState);
 }
 
 void AceButton::checkState(uint8_t buttonState) {
+  ACE_BUTTON_STATS_INCREMENT(mButtonConfig, checks);
+
   // Retrieve the current time just once and use that in the various checkXxx()
   // functions below. This provides some robustness of the various timing
   // algorithms even if one of the event handlers takes more time than the
   // threshold time limits such as 'debounceDelay' or longPressDelay'.
   uint16_t now = mButtonConfig->getClock();
 
+#if ACE_BUTTON_POLL_MONITOR
+  mButtonConfig->recordPoll(this, now);
+#endif
+
   // Send heart beat if enabled and needed. Purposely placed outside of the
   // checkDebounced() guard so that it can fire regardless of the state of the
   // debouncing logic.
   checkHeartBeat(now);
 
+#if ACE_BUTTON_BOUNCE_STATS
+  // Placed before the debouncing, which hides the raw changes.
+  checkBounce(now, buttonState);
+#endif
+
   // Debounce the button, and send any events detected.
   if (checkDebounced(now, buttonState)) {
     // check if the button was initialized (i.e. UNKNOWN state)
@@ -139,7 +168,17 @@ void AceButton::checkState(uint8_t buttonState) {
   }
 }
 
+void AceButton::checkDebouncedState(uint16_t now, uint8_t buttonState) {
+  ACE_BUTTON_STATS_INCREMENT(mButtonConfig, checks);
+  checkHeartBeat(now);
+  if (checkInitialized(buttonState)) {
+    checkEvent(now, buttonState);
+  }
+}
+
 void AceButton::checkEvent(uint16_t now, uint8_t buttonState) {
+  ACE_BUTTON_PROFILE_SCOPE(kProfileCheckEvent);
+
   // We need to remove orphaned clicks even if just Click is enabled. It is not
   // sufficient to do this for just DoubleClick. That's because it's possible
   // for a Clicked event to be generated, then 65.536 seconds later, the
@@ -168,7 +207,11 @@ void AceButton::checkEvent(uint16_t now, uint8_t buttonState) {
   }
 }
 
+#if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_DELAY
+
 bool AceButton::checkDebounced(uint16_t now, uint8_t buttonState) {
+  ACE_BUTTON_PROFILE_SCOPE(kProfileCheckDebounced);
+
   if (isFlag(kFlagDebouncing)) {
 
     // NOTE: This is a bit tricky. The elapsedTime will be valid even if the
@@ -187,6 +230,11 @@ bool AceButton::checkDebounced(uint16_t now, uint8_t buttonState) {
 
     if (isDebouncingTimeOver) {
       clearFlag(kFlagDebouncing);
+      ACE_BUTTON_TRACE_POINT(kTraceDebounceEnd, now, buttonState);
+      // The button went back to its previous state during debouncing.
+      if (buttonState == getLastButtonState()) {
+        ACE_BUTTON_STATS_INCREMENT(mButtonConfig, bounces);
+      }
       return true;
     } else {
       return false;
@@ -200,12 +248,105 @@ bool AceButton::checkDebounced(uint16_t now, uint8_t buttonState) {
     }
 
     // button has changed so, enter debouncing phase
+    ACE_BUTTON_STATS_INCREMENT(mButtonConfig, rawChanges);
     setFlag(kFlagDebouncing);
     mLastDebounceTime = now;
+    ACE_BUTTON_TRACE_POINT(kTraceDebounceStart, now, buttonState);
     return false;
   }
 }
 
+#elif ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_LOCKOUT
+
+bool AceButton::checkDebounced(uint16_t now, uint8_t buttonState) {
+  ACE_BUTTON_PROFILE_SCOPE(kProfileCheckDebounced);
+
+  // Ignore the input until the lockout period after the last accepted change
+  // is over. See the DELAY version for the reason for the uint16_t cast.
+  if (isFlag(kFlagDebouncing)) {
+    uint16_t elapsedTime = now - mLastDebounceTime;
+    if (elapsedTime < getLockoutDelay()) return false;
+    clearFlag(kFlagDebouncing);
+    ACE_BUTTON_TRACE_POINT(kTraceDebounceEnd, now, buttonState);
+  }
+
+  if (buttonState == getLastButtonState()) {
+    return true;
+  }
+
+  // Accept the first edge immediately, then lock out the bounces.
+  ACE_BUTTON_STATS_INCREMENT(mButtonConfig, rawChanges);
+  setFlag(kFlagDebouncing);
+  mLastDebounceTime = now;
+  ACE_BUTTON_TRACE_POINT(kTraceDebounceStart, now, buttonState);
+  return true;
+}
+
+#else // ACE_BUTTON_DEBOUNCE_SAMPLED
+
+bool AceButton::checkDebounced(uint16_t now, uint8_t buttonState) {
+  ACE_BUTTON_PROFILE_SCOPE(kProfileCheckDebounced);
+
+  // The 'now' is used only by the instrumentation.
+  (void) now;
+  bool changed = (buttonState != getLastButtonState());
+
+#if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_INTEGRATOR
+  if (changed) {
+    mDebounceSamples++;
+  } else if (mDebounceSamples > 0) {
+    mDebounceSamples--;
+  }
+  bool isAccepted = (mDebounceSamples >= mButtonConfig->getDebounceSamples());
+#else
+  uint8_t samples = mButtonConfig->getDebounceSamples();
+  uint8_t mask = (samples >= 8) ? 0xFF : (1 << samples) - 1;
+  mDebounceSamples = ((mDebounceSamples << 1) | changed) & mask;
+  bool isAccepted = (mDebounceSamples == mask);
+#endif
+
+  if (!changed) {
+    // The button went back to its previous state during debouncing.
+    if (isFlag(kFlagDebouncing) && mDebounceSamples == 0) {
+      clearFlag(kFlagDebouncing);
+      ACE_BUTTON_TRACE_POINT(kTraceDebounceEnd, now, buttonState);
+      ACE_BUTTON_STATS_INCREMENT(mButtonConfig, bounces);
+    }
+    return true;
+  }
+
+  if (!isFlag(kFlagDebouncing)) {
+    ACE_BUTTON_STATS_INCREMENT(mButtonConfig, rawChanges);
+    setFlag(kFlagDebouncing);
+#if ACE_BUTTON_LATENCY
+    mLastDebounceTime = now;
+#endif
+    ACE_BUTTON_TRACE_POINT(kTraceDebounceStart, now, buttonState);
+  }
+
+  if (!isAccepted) return false;
+
+  // The samples are relative to the new state from now on.
+  clearFlag(kFlagDebouncing);
+  mDebounceSamples = 0;
+  ACE_BUTTON_TRACE_POINT(kTraceDebounceEnd, now, buttonState);
+  return true;
+}
+
+#endif
+
+#if ACE_BUTTON_BOUNCE_STATS
+
+void AceButton::checkBounce(uint16_t now, uint8_t buttonState) {
+  if (mBounceMeter.update(now, buttonState,
+      mButtonConfig->getBounceQuietTime())) {
+    mButtonConfig->recordBounce(mBounceMeter.getLastBounces(),
+        mBounceMeter.getLastSettleTime());
+  }
+}
+
+#endif
+
 bool AceButton::checkInitialized(uint16_t buttonState) {
   if (mLastButtonState != kButtonStateUnknown) {
     return true;
@@ -273,11 +414,18 @@ void AceButton::checkPressed(uint16_t now, uint8_t buttonState) {
 
   // button was pressed
   mLastPressTime = now;
+#if ACE_BUTTON_LATENCY
+  // Kept apart from mLastDebounceTime, which is overwritten by a glitch
+  // during the press.
+  mPressEdgeTime = mLastDebounceTime;
+#endif
   setFlag(kFlagPressed);
   handleEvent(kEventPressed);
 }
 
 void AceButton::checkReleased(uint16_t now, uint8_t buttonState) {
+  ACE_BUTTON_PROFILE_SCOPE(kProfileCheckReleased);
+
   if (buttonState != getDefaultReleasedState()) {
     return;
   }
@@ -318,6 +466,7 @@ void AceButton::checkReleased(uint16_t now, uint8_t buttonState) {
   // Fire off a Released event, unless suppressed. Replace Released with
   // LongReleased if this was a LongPressed.
   if (suppress) {
+    ACE_BUTTON_TRACE_POINT(kTraceSuppressed, now, kEventReleased);
     if (wasLongPressed) {
       handleEvent(kEventLongReleased);
     }
@@ -336,11 +485,29 @@ void AceButton::checkClicked(uint16_t now) {
     return;
   }
   uint16_t elapsedTime = now - mLastPressTime;
+#if ACE_BUTTON_CLICK_TUNER
+  // Recorded before the comparison with the click delay, so that the delay
+  // can grow back when the presses of the user become longer.
+  mButtonConfig->recordClickPress(elapsedTime);
+#endif
   if (elapsedTime >= mButtonConfig->getClickDelay()) {
     clearFlag(kFlagClicked);
     return;
   }
 
+#if ACE_BUTTON_CLICK_TUNER
+  // Record the interval from the previous click, even if it is longer than the
+  // double-click delay, so that the delay can grow back. The previous click is
+  // forgotten by checkOrphanedClick() after the maximum double-click delay.
+  if (isFlag(kFlagClickReleased)) {
+    mButtonConfig->recordClickInterval(now - mLastClickReleaseTime);
+  }
+  if (mButtonConfig->getClickTuner().isEnabled()) {
+    setFlag(kFlagClickReleased);
+    mLastClickReleaseTime = now;
+  }
+#endif
+
   // check for double click
   if (mButtonConfig->isFeature(ButtonConfig::kFeatureDoubleClick)) {
     checkDoubleClicked(now);
@@ -351,15 +518,22 @@ void AceButton::checkClicked(uint16_t now) {
   // from generating another double-click at the third click.
   if (isFlag(kFlagDoubleClicked)) {
     clearFlag(kFlagClicked);
+    ACE_BUTTON_TRACE_POINT(kTraceSuppressed, now, kEventClicked);
     return;
   }
 
   // we got a single click
   mLastClickTime = now;
   setFlag(kFlagClicked);
-  if (mButtonConfig->isFeature(
+  ACE_BUTTON_TRACE_POINT(kTraceClickWindowEnter, now, 0);
+  if (mButtonConfig->isFeature(ButtonConfig::kFeatureSpeculativeClick)) {
+    // Dispatched immediately, and retracted by checkDoubleClicked() if this
+    // turns out to be the first click of a double-click.
+    handleEvent(kEventClicked);
+  } else if (mButtonConfig->isFeature(
       ButtonConfig::kFeatureSuppressClickBeforeDoubleClick)) {
     setFlag(kFlagClickPostponed);
+    ACE_BUTTON_TRACE_POINT(kTraceClickPostponed, now, 0);
   } else {
     handleEvent(kEventClicked);
   }
@@ -385,6 +559,11 @@ void AceButton::checkDoubleClicked(uint16_t now) {
   // Click as requested.
   if (isFlag(kFlagClickPostponed)) {
     clearFlag(kFlagClickPostponed);
+    ACE_BUTTON_TRACE_POINT(kTraceSuppressed, now, kEventClicked);
+  } else if (mButtonConfig->isFeature(
+      ButtonConfig::kFeatureSpeculativeClick)) {
+    // The first Click was dispatched speculatively, so take it back.
+    handleEvent(kEventClickRetracted);
   }
   setFlag(kFlagDoubleClicked);
   handleEvent(kEventDoubleClicked);
@@ -404,13 +583,26 @@ void AceButton::checkOrphanedClick(uint16_t now) {
   uint16_t elapsedTime = now - mLastClickTime;
   if (isFlag(kFlagClicked) && (elapsedTime >= orphanedClickDelay)) {
     clearFlag(kFlagClicked);
+    ACE_BUTTON_TRACE_POINT(kTraceOrphanedClickReclaim, now, 0);
+  }
+
+#if ACE_BUTTON_CLICK_TUNER
+  // Forget the release of the last click once it cannot start a double-click,
+  // even with the maximum double-click delay. Otherwise, the interval to a
+  // click more than 65.536 seconds later would roll over to a small value.
+  uint16_t releaseElapsedTime = now - mLastClickReleaseTime;
+  if (isFlag(kFlagClickReleased) && releaseElapsedTime
+      >= mButtonConfig->getClickTuner().getMaxDoubleClickDelay()) {
+    clearFlag(kFlagClickReleased);
   }
+#endif
 }
 
 void AceButton::checkPostponedClick(uint16_t now) {
   uint16_t postponedClickDelay = mButtonConfig->getDoubleClickDelay();
   uint16_t elapsedTime = now - mLastClickTime;
   if (isFlag(kFlagClickPostponed) && elapsedTime >= postponedClickDelay) {
+    ACE_BUTTON_TRACE_POINT(kTracePostponedClickRelease, now, 0);
     handleEvent(kEventClicked);
     clearFlag(kFlagClickPostponed);
   }
@@ -436,8 +628,128 @@ void AceButton::checkHeartBeat(uint16_t now) {
   }
 }
 
+// Return the time remaining until 'delay' milliseconds have elapsed.
+static uint16_t remainingTime(uint16_t elapsedTime, uint16_t delay) {
+  return (elapsedTime >= delay) ? 0 : delay - elapsedTime;
+}
+
+uint16_t AceButton::getTimeToNextTimer(uint16_t now) const {
+  uint16_t next = 0xFFFF;
+
+  // The heart beat is checked outside of the debouncing guard of checkState().
+  if (mButtonConfig->isFeature(ButtonConfig::kFeatureHeartBeat)) {
+    if (! isFlag(kFlagHeartRunning)) return 0;
+    uint16_t remaining = remainingTime(now - mLastHeartBeatTime,
+        mButtonConfig->getHeartBeatInterval());
+    if (remaining < next) next = remaining;
+  }
+
+#if ACE_BUTTON_BOUNCE_STATS
+  // The measurement of the transition ends after the quiet time.
+  if (mBounceMeter.isBouncing()) {
+    uint16_t remaining = remainingTime(now - mBounceMeter.getLastChangeTime(),
+        mButtonConfig->getBounceQuietTime());
+    if (remaining < next) next = remaining;
+  }
+#endif
+
+  // The other timers are not checked until the debouncing is over.
+  if (isFlag(kFlagDebouncing)) {
+#if ACE_BUTTON_DEBOUNCE_SAMPLED
+    // The debouncing needs the next sample.
+    return 0;
+#elif ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_LOCKOUT
+    uint16_t remaining = remainingTime(now - mLastDebounceTime,
+        getLockoutDelay());
+    return (remaining < next) ? remaining : next;
+#else
+    uint16_t remaining = remainingTime(now - mLastDebounceTime,
+        mButtonConfig->getDebounceDelay());
+    return (remaining < next) ? remaining : next;
+#endif
+  }
+
+  if (isFlag(kFlagClicked | kFlagClickPostponed)
+      && (mButtonConfig->isFeature(ButtonConfig::kFeatureClick)
+          || mButtonConfig->isFeature(ButtonConfig::kFeatureDoubleClick))) {
+    uint16_t remaining = remainingTime(now - mLastClickTime,
+        mButtonConfig->getDoubleClickDelay());
+    if (remaining < next) next = remaining;
+  }
+
+#if ACE_BUTTON_CLICK_TUNER
+  if (isFlag(kFlagClickReleased)
+      && (mButtonConfig->isFeature(ButtonConfig::kFeatureClick)
+          || mButtonConfig->isFeature(ButtonConfig::kFeatureDoubleClick))) {
+    uint16_t remaining = remainingTime(now - mLastClickReleaseTime,
+        mButtonConfig->getClickTuner().getMaxDoubleClickDelay());
+    if (remaining < next) next = remaining;
+  }
+#endif
+
+  if (mLastButtonState == getDefaultReleasedState()
+      || ! isFlag(kFlagPressed)) {
+    return next;
+  }
+
+  if (mButtonConfig->isFeature(ButtonConfig::kFeatureLongPress)
+      && ! isFlag(kFlagLongPressed)) {
+    uint16_t remaining = remainingTime(now - mLastPressTime,
+        mButtonConfig->getLongPressDelay());
+    if (remaining < next) next = remaining;
+  }
+
+  if (mButtonConfig->isFeature(ButtonConfig::kFeatureRepeatPress)) {
+    uint16_t remaining = isFlag(kFlagRepeatPressed)
+        ? remainingTime(now - mLastRepeatPressTime,
+            mButtonConfig->getRepeatPressInterval())
+        : remainingTime(now - mLastPressTime,
+            mButtonConfig->getRepeatPressDelay());
+    if (remaining < next) next = remaining;
+  }
+
+  return next;
+}
+
 void AceButton::handleEvent(uint8_t eventType) {
+  ACE_BUTTON_PROFILE_SCOPE(kProfileDispatchEvent);
+
+#if ACE_BUTTON_LATENCY
+  // mLastDebounceTime is the time of the first raw change of the last
+  // transition of the button. The LongPressed and RepeatPressed events are
+  // measured from the press of the button.
+  if (eventType != kEventHeartBeat) {
+    uint16_t edgeTime = (eventType == kEventLongPressed
+        || eventType == kEventRepeatPressed)
+        ? mPressEdgeTime : mLastDebounceTime;
+    uint16_t latency = mButtonConfig->getClock() - edgeTime;
+    mButtonConfig->getMutableLatencyStats().record(eventType, latency);
+  }
+#endif
+
+#if ACE_BUTTON_FLIGHT_RECORDER
+  // Recorded before the event handler is called, in case it crashes.
+  FlightRecorder* recorder = mButtonConfig->getFlightRecorder();
+  if (recorder) {
+    recorder->record(mButtonConfig->getClock(), mId, eventType,
+        getLastButtonState());
+  }
+#endif
+
+#if ACE_BUTTON_HANDLER_WATCHDOG
+  // There is nothing to measure without an event handler.
+  bool isMeasured = mButtonConfig->hasEventHandler();
+  unsigned long startMicros = isMeasured ? mButtonConfig->getClockMicros() : 0;
+#endif
+
   mButtonConfig->dispatchEvent(this, eventType, getLastButtonState());
+
+#if ACE_BUTTON_HANDLER_WATCHDOG
+  if (isMeasured) {
+    uint32_t elapsedMicros = mButtonConfig->getClockMicros() - startMicros;
+    mButtonConfig->recordHandlerTime(this, eventType, elapsedMicros);
+  }
+#endif
 }
 
 }
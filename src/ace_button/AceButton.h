@@ -108,6 +108,17 @@ class AceButton {
      */
     static const uint8_t kEventHeartBeat = 7;
 
+    /**
+     * The last kEventClicked was the first click of a double-click, and should
+     * be undone. Sent just before kEventDoubleClicked if
+     * ButtonConfig::kFeatureSpeculativeClick is enabled, which dispatches
+     * kEventClicked immediately instead of postponing it.
+     */
+    static const uint8_t kEventClickRetracted = 8;
+
+    /** Number of event types, one more than the last kEventXxx constant. */
+    static const uint8_t kNumEventTypes = 9;
+
     /**
      * Button state is unknown. This is a third state (different from LOW or
      * HIGH) used when the class is first initialized upon reboot. No longer
@@ -156,9 +167,9 @@ class AceButton {
      * associated with the button.
      */
     explicit AceButton(
-        uint8_t pin = 0,
+        PinType pin = 0,
         uint8_t defaultReleasedState = HIGH,
-        uint8_t id = 0
+        IdType id = 0
     ) :
         mButtonConfig(ButtonConfig::getSystemButtonConfig()) {
       init(pin, defaultReleasedState, id);
@@ -189,9 +200,9 @@ class AceButton {
      */
     explicit AceButton(
         ButtonConfig* buttonConfig,
-        uint8_t pin = 0,
+        PinType pin = 0,
         uint8_t defaultReleasedState = HIGH,
-        uint8_t id = 0) {
+        IdType id = 0) {
       init(buttonConfig, pin, defaultReleasedState, id);
     }
 
@@ -201,9 +212,9 @@ class AceButton {
      * identical as the parameters in the AceButton() constructor.
      */
     void init(
-        uint8_t pin = 0,
+        PinType pin = 0,
         uint8_t defaultReleasedState = HIGH,
-        uint8_t id = 0);
+        IdType id = 0);
 
     /**
      * Similar to init(uint8_t, uint8_t, uint8_t) but takes a (ButtonConfig*) as
@@ -213,9 +224,9 @@ class AceButton {
      */
     void init(
         ButtonConfig* buttonConfig,
-        uint8_t pin = 0,
+        PinType pin = 0,
         uint8_t defaultReleasedState = HIGH,
-        uint8_t id = 0);
+        IdType id = 0);
 
     /** Get the ButtonConfig associated with this Button. */
     ButtonConfig* getButtonConfig() const {
@@ -266,10 +277,10 @@ class AceButton {
     }
 
     /** Get the button's pin number. */
-    uint8_t getPin() const { return mPin; }
+    PinType getPin() const { return mPin; }
 
     /** Get the custom identifier of the button. */
-    uint8_t getId() const { return mId; }
+    IdType getId() const { return mId; }
 
     /** Get the initial released state of the button, HIGH or LOW. */
     uint8_t getDefaultReleasedState() const;
@@ -306,6 +317,83 @@ class AceButton {
      */
     void checkState(uint8_t buttonState);
 
+    /**
+     * Version of checkState() used by EncodedButtonConfig and
+     * LadderButtonConfig, which debounce their virtual pin once for all of
+     * their buttons (see VirtualPinDebouncer). The buttonState has already
+     * been debounced, so the debouncing step of this button is skipped. The
+     * 'now' parameter is the value of ButtonConfig::getClock() which was
+     * fetched once by the caller. NOT for public consumption.
+     */
+    void checkDebouncedState(uint16_t now, uint8_t buttonState);
+
+    #if ACE_BUTTON_LATENCY
+      /**
+       * Set the time of the first raw change of the transition which is about
+       * to be given to checkDebouncedState(), from which the latency of the
+       * events of this button is measured. Used by the ButtonConfig classes
+       * which debounce their buttons themselves. NOT for public consumption.
+       */
+      void setEdgeTime(uint16_t edgeTime) { mLastDebounceTime = edgeTime; }
+    #endif
+
+    /**
+     * Return true if the button is in the Released state and has no pending
+     * debouncing, click, long press or repeat press timers. In other words,
+     * check() would dispatch no event (except a HeartBeat) as long as the
+     * button remains released. This allows a ButtonConfig to skip the
+     * processing of idle buttons. NOT for public consumption.
+     */
+    bool isIdle() const {
+      return mLastButtonState == getDefaultReleasedState()
+          && (mFlags & kFlagsBusy) == 0;
+    }
+
+    /**
+     * Return true if a change of the input is being debounced, i.e. it has
+     * not yet been accepted or rejected by the debouncing algorithm. This is
+     * used by unit tests. NOT for public consumption.
+     */
+    bool isDebouncing() const { return mFlags & kFlagDebouncing; }
+
+    /**
+     * Return the internal state flags. This is used by diagnostic tools (e.g.
+     * examples/WcetExplorer) to identify the state of the button. The meaning
+     * of the bits may change at any time. NOT for public consumption.
+     */
+    uint16_t getFlags() const { return mFlags; }
+
+    /**
+     * Return the number of milliseconds from 'now' until the earliest pending
+     * timer of this button expires (debouncing, postponed or orphaned click,
+     * long press, repeat press, or heart beat), or 0 if a timer has already
+     * expired. As long as the button state does not change, calling check()
+     * before that time would neither dispatch an event nor change the state of
+     * the button. Return 0xFFFF if no timer is pending. This allows a
+     * simulator (e.g. testing::ButtonSimulator) to jump its fake clock to the
+     * next deadline instead of polling in fixed steps. NOT for public
+     * consumption.
+     */
+    uint16_t getTimeToNextTimer(uint16_t now) const;
+
+    #if ACE_BUTTON_BOUNCE_STATS
+      /**
+       * Return the number of bounces (raw changes after the first one) of the
+       * transition of the button being measured, or of the last one.
+       * Available only if ACE_BUTTON_BOUNCE_STATS is enabled.
+       */
+      uint8_t getLastBounces() const { return mBounceMeter.getLastBounces(); }
+
+      /**
+       * Return the settle time in milliseconds (from the first to the last raw
+       * change) of the transition of the button being measured, or of the last
+       * one.
+       */
+      uint16_t getLastSettleTime() const {
+        return mBounceMeter.getLastSettleTime();
+      }
+    #endif
+
     /**
      * Returns true if the given buttonState represents a 'Released' state for
      * the button. Returns false if the buttonState is 'Pressed' or
@@ -348,7 +436,7 @@ class AceButton {
     AceButton& operator=(const AceButton&) = delete;
 
     /** Set the pin number of the button. */
-    void setPin(uint8_t pin) { mPin = pin; }
+    void setPin(PinType pin) { mPin = pin; }
 
     /**
      * Set the initial released state of the button.
@@ -360,7 +448,7 @@ class AceButton {
     void setDefaultReleasedState(uint8_t state);
 
     /** Set the identifier of the button. */
-    void setId(uint8_t id) { mId = id; }
+    void setId(IdType id) { mId = id; }
 
     // Various bit masks to store a boolean flag in the 'mFlags' field.
     // We use bit masks to save static RAM. If we had used a 'bool' type, each
@@ -375,6 +463,24 @@ class AceButton {
     static const FlagType kFlagRepeatPressed = 0x40; // mLastRepeatPressTime
     static const FlagType kFlagClickPostponed = 0x80;
     static const FlagType kFlagHeartRunning = 0x100; // mLastHeartBeatTime valid
+    #if ACE_BUTTON_CLICK_TUNER
+      static const FlagType kFlagClickReleased = 0x200; // mLastClickReleaseTime
+    #endif
+
+    /**
+     * Flags which indicate that some timer or event is pending. The release of
+     * the last click measured by the ClickTuner is pending until it is too old
+     * to start a double-click.
+     */
+    #if ACE_BUTTON_CLICK_TUNER
+      static const FlagType kFlagsBusy = kFlagDebouncing | kFlagPressed
+          | kFlagClicked | kFlagDoubleClicked | kFlagLongPressed
+          | kFlagRepeatPressed | kFlagClickPostponed | kFlagClickReleased;
+    #else
+      static const FlagType kFlagsBusy = kFlagDebouncing | kFlagPressed
+          | kFlagClicked | kFlagDoubleClicked | kFlagLongPressed
+          | kFlagRepeatPressed | kFlagClickPostponed;
+    #endif
 
     bool isFlag(FlagType flag) const {
       return mFlags & flag;
@@ -395,6 +501,26 @@ class AceButton {
      */
     bool checkDebounced(uint16_t now, uint8_t buttonState);
 
+    #if ACE_BUTTON_BOUNCE_STATS
+      /**
+       * Measure the raw changes of the button for the BounceStats of the
+       * ButtonConfig, before they are debounced by checkDebounced().
+       */
+      void checkBounce(uint16_t now, uint8_t buttonState);
+    #endif
+
+    #if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_LOCKOUT
+      /**
+       * Return the lockout delay after the last accepted change, which
+       * depends on whether the button was pressed or released.
+       */
+      uint16_t getLockoutDelay() const {
+        return (mLastButtonState == getDefaultReleasedState())
+            ? mButtonConfig->getReleaseDebounceDelay()
+            : mButtonConfig->getDebounceDelay();
+      }
+    #endif
+
     /**
      * Return true if the button was already initialzed and determined to be in
      * a HIGH or LOW state. Return false if the button was previously in
@@ -511,10 +637,10 @@ class AceButton {
     ButtonConfig* mButtonConfig;
 
     /** button pin number */
-    uint8_t mPin;
+    PinType mPin;
 
     /** identifier, e.g. an index into an array */
-    uint8_t mId;
+    IdType mId;
 
     /** Internal flags. Bit masks are defined by the kFlag* constants. */
     FlagType mFlags;
@@ -525,15 +651,45 @@ class AceButton {
      */
     uint8_t mLastButtonState;
 
+    #if ACE_BUTTON_DEBOUNCE_SAMPLED
+      /**
+       * Counter of ACE_BUTTON_DEBOUNCE_INTEGRATOR, or history of the samples
+       * of ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER (1 if the sample differed from
+       * mLastButtonState).
+       */
+      uint8_t mDebounceSamples;
+    #endif
+
     // Internal states of the button debouncing and event handling.
     // NOTE: We don't keep track of the lastDoubleClickTime, because we
     // don't support a TripleClicked event. That may change in the future.
-    uint16_t mLastDebounceTime; // ms
+    #if ! ACE_BUTTON_DEBOUNCE_SAMPLED || ACE_BUTTON_LATENCY
+      uint16_t mLastDebounceTime; // ms, also the edge time of the latency
+    #endif
     uint16_t mLastClickTime; // ms
     uint16_t mLastPressTime; // ms
     uint16_t mLastRepeatPressTime; // ms
     uint16_t mLastHeartBeatTime; // ms
+
+    #if ACE_BUTTON_LATENCY
+      uint16_t mPressEdgeTime; // ms, first raw change of the last press
+    #endif
+
+    #if ACE_BUTTON_BOUNCE_STATS
+      BounceMeter<uint8_t> mBounceMeter;
+    #endif
+
+    #if ACE_BUTTON_CLICK_TUNER
+      uint16_t mLastClickReleaseTime; // ms, release of the previous click
+    #endif
 };
 
+// ButtonStats and LatencyStats are included by ButtonConfig.h before AceButton
+// is declared, so their array sizes are checked here instead.
+static_assert(ButtonStats::kNumEventTypes == AceButton::kNumEventTypes,
+    "ButtonStats::kNumEventTypes must match AceButton::kNumEventTypes");
+static_assert(LatencyStats::kNumEventTypes == AceButton::kNumEventTypes,
+    "LatencyStats::kNumEventTypes must match AceButton::kNumEventTypes");
+
 }
 #endif
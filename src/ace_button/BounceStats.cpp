@@ -0,0 +1,45 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "BounceStats.h"
+
+namespace ace_button {
+
+#if ACE_BUTTON_BOUNCE_STATS
+
+void BounceStats::printTo(Print& printer) const {
+  printer.println(F("min,max,count"));
+  for (uint8_t i = 0; i < LatencyHistogram::kNumBuckets; i++) {
+    if (settleTimes.counts[i] == 0) continue;
+    printer.print(LatencyHistogram::bucketMin(i));
+    printer.print(',');
+    printer.print(LatencyHistogram::bucketMax(i));
+    printer.print(',');
+    printer.println(settleTimes.counts[i]);
+  }
+}
+
+#endif
+
+}
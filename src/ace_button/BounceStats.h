@@ -0,0 +1,247 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_BOUNCE_STATS_H
+#define ACE_BUTTON_BOUNCE_STATS_H
+
+#include <string.h> // memset()
+#include <Arduino.h>
+#include "LatencyStats.h" // LatencyHistogram
+
+/**
+ * Set to 1 to measure the contact bounces of each transition of every
+ * AceButton, to collect them in a BounceStats of every ButtonConfig, and to
+ * make the DebounceTuner of the ButtonConfig available. This must be set in
+ * the build flags of the whole project (e.g. -D ACE_BUTTON_BOUNCE_STATS=1) so
+ * that the library and the application see the same layout of AceButton and
+ * ButtonConfig. When set to 0 (the default), nothing is measured, and the code
+ * is not compiled.
+ */
+#if ! defined(ACE_BUTTON_BOUNCE_STATS)
+  #define ACE_BUTTON_BOUNCE_STATS 0
+#endif
+
+namespace ace_button {
+
+/**
+ * Contact bounces of the buttons of a ButtonConfig, collected when
+ * ACE_BUTTON_BOUNCE_STATS is enabled. A transition starts with the first raw
+ * change of a button after its input has been quiet, and ends when the input
+ * has been quiet again for ButtonConfig::getBounceQuietTime(), on a different
+ * state than before it (see BounceMeter). Its bounces are
+ * the raw changes after the first one, and its settle time is the time from
+ * the first to the last raw change. The settle time is measured with the
+ * resolution of the polling interval of AceButton::check().
+ */
+struct BounceStats {
+  /** Number of transitions measured. */
+  uint32_t transitions;
+
+  /** Total number of bounces of all transitions. */
+  uint32_t bounces;
+
+  /** Longest settle time in milliseconds. */
+  uint16_t maxSettleTime;
+
+  /** Largest number of bounces of a single transition. */
+  uint8_t maxBounces;
+
+  /** Histogram of the settle times, in milliseconds. */
+  LatencyHistogram settleTimes;
+
+  /** Record a transition. */
+  void record(uint8_t numBounces, uint16_t settleTime) {
+    transitions++;
+    bounces += numBounces;
+    if (numBounces > maxBounces) maxBounces = numBounces;
+    if (settleTime > maxSettleTime) maxSettleTime = settleTime;
+    settleTimes.add(settleTime);
+  }
+
+  /** Set all fields to 0. */
+  void reset() {
+    memset(this, 0, sizeof(*this));
+  }
+
+  /**
+   * Print the non-empty buckets of the settle times in CSV format, one per
+   * line, preceded by a header line: "min,max,count", where 'min' and 'max'
+   * are the bounds of the bucket in milliseconds.
+   */
+  void printTo(Print& printer) const;
+};
+
+/**
+ * Measures the transitions of a raw input for the BounceStats of a
+ * ButtonConfig. The input is the state of an AceButton, or the virtual pin of
+ * a VirtualPinDebouncer. A transition starts with a raw change after the input
+ * has been quiet, and ends when it has been quiet again for the bounce quiet
+ * time. A transition which returns to the value before its first change (a
+ * clean press shorter than the quiet time, or a single spike) did not change
+ * the debounced state, so it is not reported.
+ *
+ * @tparam T type of the raw value, e.g. uint8_t or PinType
+ */
+template <typename T>
+class BounceMeter {
+  public:
+    BounceMeter() = default;
+
+    /** Reset to the initial state where no raw value has been seen. */
+    void reset() { mFlags = 0; }
+
+    /**
+     * Process the raw value read at time 'now'. Return true if a transition
+     * ended at 'now' on a value different from the one before it. Its bounces
+     * and settle time are returned by getLastBounces() and
+     * getLastSettleTime().
+     */
+    bool update(uint16_t now, T raw, uint16_t quietTime) {
+      if (!(mFlags & kFlagRawValid)) {
+        mFlags |= kFlagRawValid;
+        mRaw = raw;
+        return false;
+      }
+
+      if (raw != mRaw) {
+        if (mFlags & kFlagBouncing) {
+          if (mBounceCount != 0xFF) mBounceCount++;
+        } else {
+          mFlags |= kFlagBouncing;
+          mStartTime = now;
+          mStartValue = mRaw;
+          mBounceCount = 0;
+        }
+        mRaw = raw;
+        mLastTime = now;
+        return false;
+      }
+
+      if (!(mFlags & kFlagBouncing)) return false;
+      uint16_t elapsedTime = now - mLastTime;
+      if (elapsedTime < quietTime) return false;
+      mFlags &= ~kFlagBouncing;
+      return raw != mStartValue;
+    }
+
+    /** Return true if a transition is being measured. */
+    bool isBouncing() const { return mFlags & kFlagBouncing; }
+
+    /** Return the time of the last raw change. */
+    uint16_t getLastChangeTime() const { return mLastTime; }
+
+    /**
+     * Return the number of bounces (raw changes after the first one) of the
+     * transition being measured, or of the last one.
+     */
+    uint8_t getLastBounces() const { return mBounceCount; }
+
+    /**
+     * Return the settle time in milliseconds (from the first to the last raw
+     * change) of the transition being measured, or of the last one.
+     */
+    uint16_t getLastSettleTime() const { return mLastTime - mStartTime; }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    BounceMeter(const BounceMeter&) = delete;
+    BounceMeter& operator=(const BounceMeter&) = delete;
+
+    /** mRaw is valid. */
+    static const uint8_t kFlagRawValid = 0x01;
+
+    /** A transition started at mStartTime is being measured. */
+    static const uint8_t kFlagBouncing = 0x02;
+
+    uint16_t mStartTime = 0; // ms, first raw change of the transition
+    uint16_t mLastTime = 0; // ms, last raw change of the transition
+    T mRaw = 0; // last raw value
+    T mStartValue = 0; // raw value before the transition
+    uint8_t mBounceCount = 0; // raw changes after the first, saturated at 255
+    uint8_t mFlags = 0;
+};
+
+/**
+ * Estimates the settle time of the buttons of a ButtonConfig from the
+ * transitions measured with ACE_BUTTON_BOUNCE_STATS, and derives the debounce
+ * delay from it. The estimate holds the longest recent settle time, and decays
+ * by 1/16 at each transition, so that a switch which bounces for a long time
+ * only once in a while is still covered. The debounce delay is the estimate
+ * plus a margin of 25% and 1 ms, clamped to the bounds.
+ */
+class DebounceTuner {
+  public:
+    DebounceTuner() = default;
+
+    /**
+     * Set the bounds of the debounce delay, in milliseconds. A maxDelay of 0
+     * disables the tuner.
+     */
+    void setBounds(uint16_t minDelay, uint16_t maxDelay) {
+      mMinDelay = minDelay;
+      mMaxDelay = maxDelay;
+    }
+
+    /** Return true if the tuner is enabled. */
+    bool isEnabled() const { return mMaxDelay != 0; }
+
+    /** Lower bound of the debounce delay. */
+    uint16_t getMinDelay() const { return mMinDelay; }
+
+    /** Upper bound of the debounce delay. */
+    uint16_t getMaxDelay() const { return mMaxDelay; }
+
+    /** Return the estimate of the settle time in milliseconds. */
+    uint16_t getSettleEstimate() const { return mSettleEstimate; }
+
+    /** Forget the estimate of the settle time. */
+    void reset() { mSettleEstimate = 0; }
+
+    /**
+     * Update the estimate with the settle time of a transition, and return
+     * the new debounce delay.
+     */
+    uint16_t update(uint16_t settleTime) {
+      mSettleEstimate -= mSettleEstimate >> 4;
+      if (settleTime > mSettleEstimate) mSettleEstimate = settleTime;
+
+      uint32_t delay = (uint32_t) mSettleEstimate + (mSettleEstimate >> 2) + 1;
+      if (delay < mMinDelay) return mMinDelay;
+      if (delay > mMaxDelay) return mMaxDelay;
+      return (uint16_t) delay;
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    DebounceTuner(const DebounceTuner&) = delete;
+    DebounceTuner& operator=(const DebounceTuner&) = delete;
+
+    uint16_t mMinDelay = 0;
+    uint16_t mMaxDelay = 0;
+    uint16_t mSettleEstimate = 0;
+};
+
+}
+
+#endif
@@ -23,10 +23,32 @@ SOFTWARE.
 */
 
 #include "ButtonConfig.h"
+#include "AceButton.h"
 
 namespace ace_button {
 
 // The default "System" instance of a ButtonConfig.
 ButtonConfig ButtonConfig::sSystemButtonConfig;
 
+#if ACE_BUTTON_HANDLER_WATCHDOG
+
+void ButtonConfig::recordHandlerTime(AceButton* button, uint8_t eventType,
+    uint32_t elapsedMicros) {
+  mHandlerStats.count++;
+  if (elapsedMicros > mHandlerStats.maxMicros) {
+    mHandlerStats.maxMicros = elapsedMicros;
+    mHandlerStats.worstId = button->getId();
+    mHandlerStats.worstEventType = eventType;
+  }
+
+  if (mHandlerBudget != 0 && elapsedMicros > mHandlerBudget) {
+    mHandlerStats.overBudget++;
+    if (mBudgetExceededHandler) {
+      mBudgetExceededHandler(button, eventType, elapsedMicros);
+    }
+  }
+}
+
+#endif
+
 }
@@ -27,6 +27,14 @@ SOFTWARE.
 
 #include <Arduino.h>
 #include "IEventHandler.h"
+#include "ButtonStats.h"
+#include "LatencyStats.h"
+#include "BounceStats.h"
+#include "ClickTuner.h"
+#include "HandlerWatchdog.h"
+#include "PollMonitor.h"
+#include "PinType.h"
+#include "FlightRecorder.h"
 
 // https://stackoverflow.com/questions/295120
 #if defined(__GNUC__) || defined(__clang__)
@@ -38,6 +46,42 @@ SOFTWARE.
   #define ACE_BUTTON_DEPRECATED
 #endif
 
+// Set ACE_BUTTON_DEBOUNCE (in the build flags of the whole project) to select
+// the debouncing algorithm of AceButton::check():
+//
+//  * ACE_BUTTON_DEBOUNCE_DELAY (default): the first change of the input opens
+//    a window of getDebounceDelay() milliseconds, and the input read at the
+//    end of the window is accepted. The changes within the window do not
+//    restart it.
+//  * ACE_BUTTON_DEBOUNCE_INTEGRATOR: a counter is incremented by each sample
+//    which differs from the debounced state, and decremented by each sample
+//    which does not. The change is accepted when the counter reaches
+//    getDebounceSamples(). Isolated spikes do not restart the debouncing.
+//  * ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER: the change is accepted when the last
+//    getDebounceSamples() samples (at most 8) all differ from the debounced
+//    state.
+//  * ACE_BUTTON_DEBOUNCE_LOCKOUT: a change is accepted immediately, then the
+//    input is ignored for getDebounceDelay() milliseconds after a press, or
+//    getReleaseDebounceDelay() milliseconds after a release.
+//
+// The INTEGRATOR and SHIFT_REGISTER count the calls to check() instead of
+// milliseconds, so they do not need the debouncing timestamp of each
+// AceButton (unless ACE_BUTTON_LATENCY is enabled). The EncodedButtonConfig
+// and LadderButtonConfig debounce their virtual pin using the
+// ACE_BUTTON_DEBOUNCE_DELAY algorithm in all cases.
+#define ACE_BUTTON_DEBOUNCE_DELAY 0
+#define ACE_BUTTON_DEBOUNCE_INTEGRATOR 1
+#define ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER 2
+#define ACE_BUTTON_DEBOUNCE_LOCKOUT 3
+#if ! defined(ACE_BUTTON_DEBOUNCE)
+  #define ACE_BUTTON_DEBOUNCE ACE_BUTTON_DEBOUNCE_DELAY
+#endif
+
+// True if the debouncing algorithm counts samples instead of milliseconds.
+#define ACE_BUTTON_DEBOUNCE_SAMPLED \
+    (ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_INTEGRATOR \
+    || ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER)
+
 namespace ace_button {
 
 class AceButton;
@@ -82,6 +126,11 @@ class ButtonConfig {
     /** Default milliseconds returned by getDebounceDelay(). */
     static const uint16_t kDebounceDelay = 20;
 
+    #if ACE_BUTTON_DEBOUNCE_SAMPLED
+      /** Default number of samples returned by getDebounceSamples(). */
+      static const uint8_t kDebounceSamples = 4;
+    #endif
+
     /** Default milliseconds returned by getClickDelay(). */
     static const uint16_t kClickDelay = 200;
 
@@ -100,6 +149,17 @@ class ButtonConfig {
     /** Default milliseconds returned by getHeartBeatInterval(). */
     static const uint16_t kHeartBeatInterval = 5000;
 
+    #if ACE_BUTTON_BOUNCE_STATS
+      /** Default milliseconds returned by getBounceQuietTime(). */
+      static const uint16_t kBounceQuietTime = 50;
+    #endif
+
+    /**
+     * Pin number which indicates that an optional pin (e.g. the "any pressed"
+     * pin of EncodedButtonConfig) is not connected.
+     */
+    static const uint8_t kNoPin = 0xFF;
+
     // Various features controlled by feature flags.
 
     /**
@@ -152,6 +212,15 @@ class ButtonConfig {
     /** Flag to enable periodic kEventHeartBeat. */
     static const FeatureFlagType kFeatureHeartBeat = 0x200;
 
+    /**
+     * Flag to dispatch kEventClicked immediately, even if a
+     * kEventDoubleClicked may follow, and to send a kEventClickRetracted just
+     * before the kEventDoubleClicked if it does. This gives zero-latency
+     * clicks to event handlers which can undo a click cheaply. It takes
+     * precedence over kFeatureSuppressClickBeforeDoubleClick.
+     */
+    static const FeatureFlagType kFeatureSpeculativeClick = 0x400;
+
     /**
      * Internal flag to indicate that mEventHandler is an IEventHandler object
      * pointer instead of an EventHandler function pointer.
@@ -221,6 +290,26 @@ class ButtonConfig {
     /** Milliseconds to wait for debouncing. */
     uint16_t getDebounceDelay() const { return mDebounceDelay; }
 
+    #if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_LOCKOUT
+      /**
+       * Milliseconds of the lockout after a release, when the input is
+       * ignored. The getDebounceDelay() is the lockout after a press.
+       * Available only if ACE_BUTTON_DEBOUNCE is ACE_BUTTON_DEBOUNCE_LOCKOUT.
+       */
+      uint16_t getReleaseDebounceDelay() const {
+        return mReleaseDebounceDelay;
+      }
+    #endif
+
+    #if ACE_BUTTON_DEBOUNCE_SAMPLED
+      /**
+       * Number of samples (i.e. calls to AceButton::check()) needed to accept
+       * a change of the button. Available only if ACE_BUTTON_DEBOUNCE is
+       * ACE_BUTTON_DEBOUNCE_INTEGRATOR or ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER.
+       */
+      uint8_t getDebounceSamples() const { return mDebounceSamples; }
+    #endif
+
     /** Milliseconds to wait for a possible click. */
     uint16_t getClickDelay() const { return mClickDelay; }
 
@@ -262,6 +351,23 @@ class ButtonConfig {
       mDebounceDelay = debounceDelay;
     }
 
+    #if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_LOCKOUT
+      /** Set the releaseDebounceDelay milliseconds */
+      void setReleaseDebounceDelay(uint16_t releaseDebounceDelay) {
+        mReleaseDebounceDelay = releaseDebounceDelay;
+      }
+    #endif
+
+    #if ACE_BUTTON_DEBOUNCE_SAMPLED
+      /**
+       * Set the number of debouncing samples. The
+       * ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER uses at most 8 samples.
+       */
+      void setDebounceSamples(uint8_t debounceSamples) {
+        mDebounceSamples = debounceSamples;
+      }
+    #endif
+
     /** Set the clickDelay milliseconds */
     void setClickDelay(uint16_t clickDelay) {
       mClickDelay = clickDelay;
@@ -313,11 +419,24 @@ class ButtonConfig {
      *
      * Note: This should have been a const function. I cannot change it now
      * without breaking backwards compatibility.
+     *
+     * The 'pin' is a PinType which is a uint8_t, unless ACE_BUTTON_WIDE_PINS
+     * is enabled. Subclasses which override this method with a `uint8_t pin`
+     * parameter continue to work in the default configuration.
      */
-    virtual int readButton(uint8_t pin) {
+    virtual int readButton(PinType pin) {
       return digitalRead(pin);
     }
 
+    #if ACE_BUTTON_HANDLER_WATCHDOG
+      /**
+       * Return the microseconds of the clock used to measure the execution
+       * time of the event handler. Override to use something other than
+       * micros(). Available only if ACE_BUTTON_HANDLER_WATCHDOG is enabled.
+       */
+      virtual unsigned long getClockMicros() { return micros(); }
+    #endif
+
     // These methods provide access to various feature flags that control the
     // functionality of the AceButton.
 
@@ -370,6 +489,12 @@ class ButtonConfig {
     void dispatchEvent(AceButton* button, uint8_t eventType,
         uint8_t buttonState) const {
 
+    #if ACE_BUTTON_STATS
+      if (eventType < ButtonStats::kNumEventTypes) {
+        mStats.events[eventType]++;
+      }
+    #endif
+
       if (! mEventHandler) return;
 
       if (isFeature(kInternalFeatureIEventHandler)) {
@@ -383,6 +508,12 @@ class ButtonConfig {
       }
     }
 
+    /**
+     * Return true if an event handler is installed. This is meant to be an
+     * internal method.
+     */
+    bool hasEventHandler() const { return mEventHandler != nullptr; }
+
     /**
      * Install the EventHandler function pointer. The event handler must be
      * defined for the AceButton to be useful.
@@ -409,6 +540,225 @@ class ButtonConfig {
       return &sSystemButtonConfig;
     }
 
+    #if ACE_BUTTON_STATS
+      /**
+       * Return a snapshot of the instrumentation counters of the buttons
+       * attached to this ButtonConfig. Available only if ACE_BUTTON_STATS is
+       * enabled.
+       */
+      ButtonStats getStats() const { return mStats; }
+
+      /** Set the instrumentation counters to 0. */
+      void resetStats() { mStats.reset(); }
+
+      /**
+       * Return a reference to the instrumentation counters so that they can be
+       * updated by AceButton and the subclasses. NOT for public consumption.
+       */
+      ButtonStats& getMutableStats() const { return mStats; }
+    #endif
+
+    #if ACE_BUTTON_LATENCY
+      /**
+       * Return the edge-to-dispatch latency histograms of the events of the
+       * buttons attached to this ButtonConfig. Available only if
+       * ACE_BUTTON_LATENCY is enabled.
+       */
+      const LatencyStats& getLatencyStats() const { return mLatencyStats; }
+
+      /** Set the counts of the latency histograms to 0. */
+      void resetLatencyStats() { mLatencyStats.reset(); }
+
+      /**
+       * Return a reference to the latency histograms so that they can be
+       * updated by AceButton. NOT for public consumption.
+       */
+      LatencyStats& getMutableLatencyStats() { return mLatencyStats; }
+    #endif
+
+    #if ACE_BUTTON_BOUNCE_STATS
+      /**
+       * Return the contact bounces measured on the buttons attached to this
+       * ButtonConfig. Available only if ACE_BUTTON_BOUNCE_STATS is enabled.
+       */
+      const BounceStats& getBounceStats() const { return mBounceStats; }
+
+      /** Set the contact bounce statistics to 0. */
+      void resetBounceStats() { mBounceStats.reset(); }
+
+      /**
+       * Milliseconds without a raw change of the button which end the
+       * measurement of a transition. It should be longer than the settle time
+       * of the worst switch, and shorter than the fastest clicks.
+       */
+      uint16_t getBounceQuietTime() const { return mBounceQuietTime; }
+
+      /** Set the bounceQuietTime milliseconds. */
+      void setBounceQuietTime(uint16_t bounceQuietTime) {
+        mBounceQuietTime = bounceQuietTime;
+      }
+
+      /**
+       * Adjust the debounce delay (see setDebounceDelay()) after every
+       * measured transition, from the settle time estimated by the
+       * DebounceTuner, within the given bounds in milliseconds. The separate
+       * release lockout of ACE_BUTTON_DEBOUNCE_LOCKOUT, and the sample counts
+       * of the sampled algorithms, are not adjusted.
+       */
+      void enableDebounceTuner(uint16_t minDelay, uint16_t maxDelay) {
+        mDebounceTuner.setBounds(minDelay, maxDelay);
+      }
+
+      /**
+       * Stop adjusting the debounce delay, and forget the estimate of the
+       * settle time. The current debounce delay is kept.
+       */
+      void disableDebounceTuner() {
+        mDebounceTuner.setBounds(0, 0);
+        mDebounceTuner.reset();
+      }
+
+      /** Return the DebounceTuner. */
+      const DebounceTuner& getDebounceTuner() const { return mDebounceTuner; }
+
+      /**
+       * Record the bounces and the settle time of a transition of a button,
+       * and adjust the debounce delay if the DebounceTuner is enabled. Called
+       * by AceButton, and by the VirtualPinDebouncer of the
+       * EncodedButtonConfig and LadderButtonConfig. NOT for public
+       * consumption.
+       */
+      void recordBounce(uint8_t numBounces, uint16_t settleTime) {
+        mBounceStats.record(numBounces, settleTime);
+        if (mDebounceTuner.isEnabled()) {
+          mDebounceDelay = mDebounceTuner.update(settleTime);
+        }
+      }
+    #endif
+
+    #if ACE_BUTTON_CLICK_TUNER
+      /**
+       * Learn the click timing of the user, and shrink the click delay (see
+       * setClickDelay()) and the double-click delay (see
+       * setDoubleClickDelay()) to match, but not below the given minimums in
+       * milliseconds. The current delays become the upper bounds. This reduces
+       * the latency of the Clicked event postponed by
+       * kFeatureSuppressClickBeforeDoubleClick. Available only if
+       * ACE_BUTTON_CLICK_TUNER is enabled.
+       */
+      void enableClickTuner(uint16_t minClickDelay,
+          uint16_t minDoubleClickDelay) {
+        mClickTuner.setBounds(minClickDelay, mClickDelay,
+            minDoubleClickDelay, mDoubleClickDelay);
+      }
+
+      /**
+       * Stop the learning, forget the recorded timings, and restore the click
+       * and double-click delays to their upper bounds.
+       */
+      void disableClickTuner() {
+        if (! mClickTuner.isEnabled()) return;
+        mClickDelay = mClickTuner.getMaxClickDelay();
+        mDoubleClickDelay = mClickTuner.getMaxDoubleClickDelay();
+        mClickTuner.setBounds(0, 0, 0, 0);
+      }
+
+      /** Return the ClickTuner. */
+      const ClickTuner& getClickTuner() const { return mClickTuner; }
+
+      /**
+       * Record the duration of a press which ended at the release of a
+       * button, and adjust the click delay. Called by AceButton. NOT for
+       * public consumption.
+       */
+      void recordClickPress(uint16_t duration) {
+        if (! mClickTuner.isEnabled()) return;
+        if (duration >= mClickTuner.getMaxClickDelay()) return;
+        mClickDelay = mClickTuner.recordPress(duration);
+      }
+
+      /**
+       * Record the interval between the releases of 2 consecutive clicks of a
+       * button, and adjust the double-click delay. Called by AceButton. NOT
+       * for public consumption.
+       */
+      void recordClickInterval(uint16_t interval) {
+        if (! mClickTuner.isEnabled()) return;
+        if (interval >= mClickTuner.getMaxDoubleClickDelay()) return;
+        mDoubleClickDelay = mClickTuner.recordInterval(interval);
+      }
+    #endif
+
+    #if ACE_BUTTON_HANDLER_WATCHDOG
+      /**
+       * Set the maximum execution time of a call to the event handler, in
+       * microseconds. A value of 0 (the default) disables the budget.
+       * Available only if ACE_BUTTON_HANDLER_WATCHDOG is enabled.
+       */
+      void setHandlerBudget(uint32_t budgetMicros) {
+        mHandlerBudget = budgetMicros;
+      }
+
+      /** Return the maximum execution time of the event handler. */
+      uint32_t getHandlerBudget() const { return mHandlerBudget; }
+
+      /**
+       * Install the function which is called after each call to the event
+       * handler which takes more than the budget. It may be nullptr.
+       */
+      void setBudgetExceededHandler(BudgetExceededHandler handler) {
+        mBudgetExceededHandler = handler;
+      }
+
+      /** Return the execution time statistics of the event handler. */
+      const HandlerStats& getHandlerStats() const { return mHandlerStats; }
+
+      /** Reset the execution time statistics of the event handler. */
+      void resetHandlerStats() { mHandlerStats.reset(); }
+
+      /**
+       * Record the execution time of a call to the event handler, and call the
+       * BudgetExceededHandler if it is over the budget. Called by
+       * AceButton::handleEvent(). NOT for public consumption.
+       */
+      void recordHandlerTime(AceButton* button, uint8_t eventType,
+          uint32_t elapsedMicros);
+    #endif
+
+    #if ACE_BUTTON_POLL_MONITOR
+      /**
+       * Return the statistics of the intervals between the checks of the
+       * buttons of this ButtonConfig. Available only if
+       * ACE_BUTTON_POLL_MONITOR is enabled.
+       */
+      const PollStats& getPollStats() const { return mPollMonitor.getStats(); }
+
+      /** Reset the statistics of the intervals between the checks. */
+      void resetPollStats() { mPollMonitor.reset(); }
+
+      /**
+       * Record a check of the given source (an AceButton, or the ButtonConfig
+       * itself) at time 'now'. NOT for public consumption.
+       */
+      void recordPoll(const void* source, uint16_t now) {
+        mPollMonitor.update(source, now, mDebounceDelay, mClickDelay);
+      }
+    #endif
+
+    #if ACE_BUTTON_FLIGHT_RECORDER
+      /**
+       * Record every event of the buttons of this ButtonConfig in the given
+       * FlightRecorder, which may be nullptr. Available only if
+       * ACE_BUTTON_FLIGHT_RECORDER is enabled.
+       */
+      void setFlightRecorder(FlightRecorder* recorder) {
+        mFlightRecorder = recorder;
+      }
+
+      /** Return the FlightRecorder, or nullptr. */
+      FlightRecorder* getFlightRecorder() const { return mFlightRecorder; }
+    #endif
+
   private:
     /**
      * A single static instance of ButtonConfig provided by default to all
@@ -431,12 +781,55 @@ class ButtonConfig {
     FeatureFlagType mFeatureFlags = 0;
 
     uint16_t mDebounceDelay = kDebounceDelay;
+    #if ACE_BUTTON_DEBOUNCE == ACE_BUTTON_DEBOUNCE_LOCKOUT
+      uint16_t mReleaseDebounceDelay = kDebounceDelay;
+    #endif
     uint16_t mClickDelay = kClickDelay;
     uint16_t mDoubleClickDelay = kDoubleClickDelay;
     uint16_t mLongPressDelay = kLongPressDelay;
     uint16_t mRepeatPressDelay = kRepeatPressDelay;
     uint16_t mRepeatPressInterval = kRepeatPressInterval;
     uint16_t mHeartBeatInterval = kHeartBeatInterval;
+    #if ACE_BUTTON_DEBOUNCE_SAMPLED
+      uint8_t mDebounceSamples = kDebounceSamples;
+    #endif
+
+    #if ACE_BUTTON_STATS
+      /**
+       * Instrumentation counters. Mutable because dispatchEvent() is a const
+       * method.
+       */
+      mutable ButtonStats mStats = ButtonStats();
+    #endif
+
+    #if ACE_BUTTON_LATENCY
+      /** Edge-to-dispatch latency histograms. */
+      LatencyStats mLatencyStats = LatencyStats();
+    #endif
+
+    #if ACE_BUTTON_BOUNCE_STATS
+      BounceStats mBounceStats = BounceStats();
+      DebounceTuner mDebounceTuner;
+      uint16_t mBounceQuietTime = kBounceQuietTime;
+    #endif
+
+    #if ACE_BUTTON_CLICK_TUNER
+      ClickTuner mClickTuner;
+    #endif
+
+    #if ACE_BUTTON_HANDLER_WATCHDOG
+      BudgetExceededHandler mBudgetExceededHandler = nullptr;
+      uint32_t mHandlerBudget = 0;
+      HandlerStats mHandlerStats = HandlerStats();
+    #endif
+
+    #if ACE_BUTTON_POLL_MONITOR
+      PollMonitor mPollMonitor;
+    #endif
+
+    #if ACE_BUTTON_FLIGHT_RECORDER
+      FlightRecorder* mFlightRecorder = nullptr;
+    #endif
 };
 
 }
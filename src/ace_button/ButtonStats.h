@@ -0,0 +1,105 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_BUTTON_STATS_H
+#define ACE_BUTTON_BUTTON_STATS_H
+
+#include <string.h> // memset()
+#include <Arduino.h>
+
+/**
+ * Set to 1 to collect the instrumentation counters of ButtonStats in every
+ * ButtonConfig. This must be set in the build flags of the whole project (e.g.
+ * -D ACE_BUTTON_STATS=1) so that the library and the application see the same
+ * layout of ButtonConfig. When set to 0 (the default), the counters consume no
+ * memory, and the code which updates them is not compiled.
+ */
+#if ! defined(ACE_BUTTON_STATS)
+  #define ACE_BUTTON_STATS 0
+#endif
+
+#if ACE_BUTTON_STATS
+  /** Increment the given counter of the ButtonStats of a ButtonConfig. */
+  #define ACE_BUTTON_STATS_INCREMENT(config, counter) \
+      ((config)->getMutableStats().counter++)
+#else
+  #define ACE_BUTTON_STATS_INCREMENT(config, counter) do {} while (0)
+#endif
+
+namespace ace_button {
+
+/**
+ * Instrumentation counters collected by a ButtonConfig for all the buttons
+ * attached to it, when ACE_BUTTON_STATS is enabled. They help to find buttons
+ * which chatter (many bounces relative to the raw changes), or configs which
+ * are polled more often than needed (many checks relative to the events).
+ *
+ * The counters wrap around silently when they overflow.
+ */
+struct ButtonStats {
+  /**
+   * Number of event types counted in 'events'. Must be equal to
+   * AceButton::kNumEventTypes, which is checked in AceButton.h.
+   */
+  static const uint8_t kNumEventTypes = 9;
+
+  /**
+   * Number of buttons processed by AceButton::checkState() or
+   * AceButton::checkDebouncedState(). A button skipped by the idle shortcut of
+   * EncodedButtonConfig::checkButtons() is not counted.
+   */
+  uint32_t checks;
+
+  /**
+   * Number of reads of the buttons: calls to ButtonConfig::readButton() by
+   * AceButton::check(), or reads of the virtual pin by
+   * EncodedButtonConfig::checkButtons() and LadderButtonConfig::checkButtons().
+   */
+  uint32_t reads;
+
+  /** Number of raw changes of the button state which started debouncing. */
+  uint32_t rawChanges;
+
+  /**
+   * Number of raw changes rejected by the debouncing: a debouncing period
+   * which ended with the button, or the virtual pin of an EncodedButtonConfig
+   * or LadderButtonConfig, in its previous state.
+   */
+  uint32_t bounces;
+
+  /**
+   * Number of events dispatched, indexed by event type (e.g.
+   * AceButton::kEventPressed). Counted even if no event handler is installed.
+   */
+  uint32_t events[kNumEventTypes];
+
+  /** Set all counters to 0. */
+  void reset() {
+    memset(this, 0, sizeof(*this));
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_CLICK_TUNER_H
+#define ACE_BUTTON_CLICK_TUNER_H
+
+#include <string.h> // memset()
+#include <Arduino.h>
+
+/**
+ * Set to 1 to make the ClickTuner of every ButtonConfig available, which
+ * learns the click and double-click timing of the user, and shrinks the click
+ * and double-click delays to match. This must be set in the build flags of the
+ * whole project (e.g. -D ACE_BUTTON_CLICK_TUNER=1) so that the library and
+ * the application see the same layout of AceButton and ButtonConfig. When set
+ * to 0 (the default), nothing is recorded, and the code is not compiled.
+ */
+#if ! defined(ACE_BUTTON_CLICK_TUNER)
+  #define ACE_BUTTON_CLICK_TUNER 0
+#endif
+
+namespace ace_button {
+
+/**
+ * Histogram of durations in milliseconds using 8 linear buckets of
+ * 'bucketWidth' milliseconds. Durations beyond the last bucket are ignored.
+ * When a bucket reaches 255, all counts are halved, so that old samples fade
+ * out as the timing of the user changes.
+ */
+class TimingHistogram {
+  public:
+    /** Number of buckets. */
+    static const uint8_t kNumBuckets = 8;
+
+    TimingHistogram() = default;
+
+    /** Set the width of the buckets, and clear the counts. */
+    void setBucketWidth(uint16_t bucketWidth) {
+      mBucketWidth = (bucketWidth == 0) ? 1 : bucketWidth;
+      reset();
+    }
+
+    /** Return the width of the buckets in milliseconds. */
+    uint16_t getBucketWidth() const { return mBucketWidth; }
+
+    /** Set all counts to 0. */
+    void reset() { memset(mCounts, 0, sizeof(mCounts)); }
+
+    /** Count the given duration in its bucket. */
+    void add(uint16_t duration) {
+      uint16_t bucket = duration / mBucketWidth;
+      if (bucket >= kNumBuckets) return;
+      if (mCounts[bucket] == 0xFF) {
+        for (uint8_t i = 0; i < kNumBuckets; i++) mCounts[i] >>= 1;
+      }
+      mCounts[bucket]++;
+    }
+
+    /** Return the count of the given bucket. */
+    uint8_t getCount(uint8_t bucket) const { return mCounts[bucket]; }
+
+    /** Return the sum of the counts of all buckets. */
+    uint16_t total() const {
+      uint16_t sum = 0;
+      for (uint8_t i = 0; i < kNumBuckets; i++) sum += mCounts[i];
+      return sum;
+    }
+
+    /**
+     * Return the upper bound (exclusive) of the bucket which contains the
+     * given percentile of the durations, or 0 if the histogram is empty.
+     */
+    uint16_t percentile(uint8_t percent) const {
+      uint32_t threshold = (uint32_t) total() * percent;
+      uint32_t cumulative = 0;
+      for (uint8_t i = 0; i < kNumBuckets; i++) {
+        cumulative += mCounts[i];
+        if (cumulative != 0 && cumulative * 100 >= threshold) {
+          return (uint16_t) ((i + 1) * mBucketWidth);
+        }
+      }
+      return 0;
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    TimingHistogram(const TimingHistogram&) = delete;
+    TimingHistogram& operator=(const TimingHistogram&) = delete;
+
+    uint16_t mBucketWidth = 1;
+    uint8_t mCounts[kNumBuckets] = {};
+};
+
+/**
+ * Learns the click timing of the user of the buttons of a ButtonConfig, when
+ * ACE_BUTTON_CLICK_TUNER is enabled. It records the duration of the presses
+ * shorter than the maximum click delay, and the interval between the releases
+ * of 2 consecutive clicks shorter than the maximum double-click delay. The
+ * click (or double-click) delay is the upper bound of the bucket of the 95th
+ * percentile of the presses (or intervals) plus one bucket of margin, clamped
+ * to the bounds. The maximum delays are used until 8 samples are recorded.
+ */
+class ClickTuner {
+  public:
+    /** Percentile of the recorded timings covered by the delays. */
+    static const uint8_t kPercentile = 95;
+
+    /** Number of samples needed before the delay is shrunk. */
+    static const uint8_t kMinSamples = 8;
+
+    ClickTuner() = default;
+
+    /**
+     * Set the bounds of the click and double-click delays in milliseconds,
+     * and forget the recorded timings. A maxClickDelay of 0 disables the
+     * tuner.
+     */
+    void setBounds(uint16_t minClickDelay, uint16_t maxClickDelay,
+        uint16_t minDoubleClickDelay, uint16_t maxDoubleClickDelay) {
+      mMinClickDelay = minClickDelay;
+      mMaxClickDelay = maxClickDelay;
+      mMinDoubleClickDelay = minDoubleClickDelay;
+      mMaxDoubleClickDelay = maxDoubleClickDelay;
+      mPresses.setBucketWidth(
+          (maxClickDelay + TimingHistogram::kNumBuckets - 1)
+          / TimingHistogram::kNumBuckets);
+      mIntervals.setBucketWidth(
+          (maxDoubleClickDelay + TimingHistogram::kNumBuckets - 1)
+          / TimingHistogram::kNumBuckets);
+    }
+
+    /** Return true if the tuner is enabled. */
+    bool isEnabled() const { return mMaxClickDelay != 0; }
+
+    /** Upper bound of the click delay. */
+    uint16_t getMaxClickDelay() const { return mMaxClickDelay; }
+
+    /** Upper bound of the double-click delay. */
+    uint16_t getMaxDoubleClickDelay() const { return mMaxDoubleClickDelay; }
+
+    /** Return the histogram of the press durations. */
+    const TimingHistogram& getPresses() const { return mPresses; }
+
+    /** Return the histogram of the intervals between 2 clicks. */
+    const TimingHistogram& getIntervals() const { return mIntervals; }
+
+    /** Record the duration of a press, and return the new click delay. */
+    uint16_t recordPress(uint16_t duration) {
+      mPresses.add(duration);
+      return delayOf(mPresses, mMinClickDelay, mMaxClickDelay);
+    }
+
+    /**
+     * Record the interval between the releases of 2 clicks, and return the new
+     * double-click delay.
+     */
+    uint16_t recordInterval(uint16_t interval) {
+      mIntervals.add(interval);
+      return delayOf(mIntervals, mMinDoubleClickDelay, mMaxDoubleClickDelay);
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    ClickTuner(const ClickTuner&) = delete;
+    ClickTuner& operator=(const ClickTuner&) = delete;
+
+    static uint16_t delayOf(const TimingHistogram& histogram,
+        uint16_t minDelay, uint16_t maxDelay) {
+      if (histogram.total() < kMinSamples) return maxDelay;
+      uint32_t delay = (uint32_t) histogram.percentile(kPercentile)
+          + histogram.getBucketWidth();
+      if (delay < minDelay) return minDelay;
+      if (delay > maxDelay) return maxDelay;
+      return (uint16_t) delay;
+    }
+
+    uint16_t mMinClickDelay = 0;
+    uint16_t mMaxClickDelay = 0;
+    uint16_t mMinDoubleClickDelay = 0;
+    uint16_t mMaxDoubleClickDelay = 0;
+    TimingHistogram mPresses;
+    TimingHistogram mIntervals;
+};
+
+}
+
+#endif
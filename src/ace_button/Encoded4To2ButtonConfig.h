@@ -68,7 +68,7 @@ class Encoded4To2ButtonConfig : public ButtonConfig {
      * states of the actual pins. LOW means that the corresponding encoded
      * virtual pin was pushed.
      */
-    int readButton(uint8_t pin) override {
+    int readButton(PinType pin) override {
       int s0 = digitalRead(mPin0);
       int s1 = digitalRead(mPin1);
 
@@ -63,20 +63,37 @@ class Encoded8To3ButtonConfig : public ButtonConfig {
      * of the virtual button, so that it matches the wiring of the physical
      * buttons. The LS74148 encoder uses a pull-up wiring, so this should be set
      * HIGH. The default value is HIGH.
+     * @param anyPressedPin optional pin which becomes active (i.e. has the
+     * same pressed state as the encoder pins) when any button is pressed, for
+     * example, the GS (group select) output of the 74LS148 encoder. If given,
+     * readButton() reads only this pin while no button is pressed, instead of
+     * all 3 encoder pins. Once the encoder pins show a pressed button, they
+     * are read without this pin until they show no button again. The default
+     * value is kNoPin which disables this optimization.
      */
     Encoded8To3ButtonConfig(uint8_t pin0, uint8_t pin1, uint8_t pin2,
-        uint8_t defaultReleasedState = HIGH):
+        uint8_t defaultReleasedState = HIGH, uint8_t anyPressedPin = kNoPin):
       mPin0(pin0),
       mPin1(pin1),
       mPin2(pin2),
-      mPressedState(defaultReleasedState ^ 0x1) {}
+      mPressedState(defaultReleasedState ^ 0x1),
+      mAnyPressedPin(anyPressedPin) {}
 
     /**
      * Return state of the encoded 'pin' number, corresponding to the pull-down
      * states of the actual pins. LOW means that the corresponding encoded
      * virtual pin was pushed.
      */
-    int readButton(uint8_t pin) override {
+    int readButton(PinType pin) override {
+      // If no button was pressed at the last read of the encoder pins, and
+      // the "any pressed" pin is inactive, no button is pressed, so there is
+      // no need to read the encoder pins. While a button is pressed, the
+      // encoder pins must be read anyway, so the "any pressed" pin is skipped.
+      if (mAllReleased && mAnyPressedPin != kNoPin
+          && digitalRead(mAnyPressedPin) != mPressedState) {
+        return mPressedState ^ 0x1;
+      }
+
       int s0 = digitalRead(mPin0);
       int s1 = digitalRead(mPin1);
       int s2 = digitalRead(mPin2);
@@ -86,6 +103,7 @@ class Encoded8To3ButtonConfig : public ButtonConfig {
       uint8_t virtualPin = (s0 == mPressedState)
         | ((s1 == mPressedState) << 1)
         | ((s2 == mPressedState) << 2);
+      mAllReleased = (virtualPin == 0);
       return (virtualPin == pin) ? mPressedState : (mPressedState ^ 0x1);
     }
 
@@ -94,6 +112,10 @@ class Encoded8To3ButtonConfig : public ButtonConfig {
     const uint8_t mPin1;
     const uint8_t mPin2;
     const uint8_t mPressedState;
+    const uint8_t mAnyPressedPin;
+
+    /** The last read of the encoder pins showed no button pressed. */
+    bool mAllReleased = true;
 };
 
 }
@@ -27,46 +27,43 @@ SOFTWARE.
 
 namespace ace_button {
 
-EncodedButtonConfig::EncodedButtonConfig(
-      uint8_t numPins, const uint8_t pins[], uint8_t numButtons,
-      AceButton* const buttons[], uint8_t defaultReleasedState):
+EncodedButtonConfigBase::EncodedButtonConfigBase(
+      uint8_t numPins, const uint8_t pins[], uint8_t defaultReleasedState,
+      uint8_t anyPressedPin):
+    VirtualPinButtonConfig(defaultReleasedState),
+    mPins(pins),
     mNumPins(numPins),
+    mAnyPressedPin(anyPressedPin) {}
+
+EncodedButtonConfig::EncodedButtonConfig(
+      uint8_t numPins, const uint8_t pins[], PinType numButtons,
+      AceButton* const buttons[], uint8_t defaultReleasedState,
+      uint8_t anyPressedPin):
+    EncodedButtonConfigBase(numPins, pins, defaultReleasedState,
+        anyPressedPin),
     mNumButtons(numButtons),
-    mPressedState(defaultReleasedState ^ 0x1),
-    mPins(pins),
     mButtons(buttons) {
-  for (uint8_t i = 0; i < mNumButtons; i++) {
+  for (PinType i = 0; i < mNumButtons; i++) {
     AceButton* button = mButtons[i];
     button->setButtonConfig(this);
   }
 }
 
-int EncodedButtonConfig::readButton(uint8_t pin) {
-  uint8_t virtualPin = getVirtualPin();
-  return (virtualPin == pin) ? mPressedState : (mPressedState ^ 0x1);
+void EncodedButtonConfig::checkButtons() {
+  checkButtonArray(mButtons, mNumButtons);
 }
 
-void EncodedButtonConfig::checkButtons() const {
-  uint8_t virtualPin = getVirtualPin();
-  for (uint8_t i = 0; i < mNumButtons; i++) {
-    AceButton* button = mButtons[i];
-    if (button == nullptr) continue;
-
-    // For each button, call checkState() to allow it to figure out which
-    // state it should move it.
-    uint8_t buttonPin = button->getPin();
-    uint8_t buttonState = (buttonPin == virtualPin)
-        ? mPressedState : (mPressedState ^ 0x1);
-    button->checkState(buttonState);
-  }
+bool EncodedButtonConfigBase::isAnyPressed() const {
+  if (mAnyPressedPin == kNoPin) return true;
+  return digitalRead(mAnyPressedPin) == mPressedState;
 }
 
-uint8_t EncodedButtonConfig::getVirtualPin() const {
-  uint8_t virtualPin = 0;
+PinType EncodedButtonConfigBase::getVirtualPin() const {
+  PinType virtualPin = 0;
   for (uint8_t i = 0; i < mNumPins; i++) {
     uint8_t pin = mPins[i];
     int s = digitalRead(pin);
-    virtualPin |= (s == mPressedState) << i;
+    virtualPin |= (PinType) (s == mPressedState) << i;
   }
   return virtualPin;
 }
@@ -26,10 +26,95 @@ SOFTWARE.
 #define ACE_BUTTON_ENCODED_BUTTON_CONFIG_H
 
 #include "ButtonConfig.h"
+#include "AceButton.h"
+#include "VirtualPinButtonConfig.h"
 
 namespace ace_button {
 
-class AceButton;
+/**
+ * The part of EncodedButtonConfig which reads and debounces the encoder pins,
+ * without the array of buttons. It is the base class of EncodedButtonConfig,
+ * which references its buttons through an array of pointers, and of
+ * EncodedButtonConfigN, which owns its buttons.
+ */
+class EncodedButtonConfigBase : public VirtualPinButtonConfig {
+  public:
+    /** The virtual pin of the first button. 0 means "no button" pressed. */
+    static const PinType kFirstButtonPin = 1;
+
+    /** The virtual button pin number corresponding to "no button" pressed. */
+    PinType getNoButtonPin() const {
+      return 0;
+    }
+
+  protected:
+    /** See EncodedButtonConfig::EncodedButtonConfig() for the parameters. */
+    EncodedButtonConfigBase(uint8_t numPins, const uint8_t pins[],
+        uint8_t defaultReleasedState, uint8_t anyPressedPin);
+
+    /**
+     * Return the virtual pin number corresponding to the combinatorial states
+     * of the actual pins. Returns a number between 1 and (2^{numPins} - 1). 0
+     * means "no button" pressed.
+     */
+    PinType getVirtualPin() const override;
+
+    /**
+     * Return true if the "any pressed" pin indicates that a button may be
+     * pressed, or if the "any pressed" pin is not connected.
+     */
+    virtual bool isAnyPressed() const;
+
+    /** Reset the shared debouncer of the virtual pin. Used by unit tests. */
+    void resetDebouncer() {
+      VirtualPinButtonConfig::resetDebouncer();
+      mAllIdle = false;
+    }
+
+    /**
+     * Implementation of checkButtons() for an array of buttons. T_BUTTON is
+     * either `AceButton* const` for the array of pointers given to the
+     * EncodedButtonConfig constructor, or AceButton (or a subclass) for the
+     * contiguous array owned by EncodedButtonConfigN.
+     */
+    template <typename T_BUTTON>
+    void checkButtonArray(T_BUTTON buttons[], PinType numButtons) {
+    #if ACE_BUTTON_POLL_MONITOR
+      // Measured before the idle shortcut, which is still a check.
+      recordPoll(this, getClock());
+    #endif
+
+      // If every button was idle during the previous scan, and the "any
+      // pressed" pin says that nothing is pressed, then no button can generate
+      // an event. Skip reading the encoder pins and processing the buttons.
+      // The HeartBeat event requires every button to be checked, so it
+      // disables this shortcut.
+      if (mAllIdle && !isFeature(kFeatureHeartBeat) && !isAnyPressed()) return;
+
+      uint16_t now = getClock();
+      mAllIdle = checkVirtualPin(now, getVirtualPin(), getNoButtonPin(),
+          buttons, numButtons);
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    EncodedButtonConfigBase(const EncodedButtonConfigBase&) = delete;
+    EncodedButtonConfigBase& operator=(const EncodedButtonConfigBase&) =
+        delete;
+
+  private:
+    // Arranged for efficient packing on 32-bit processors, the bytes after
+    // the pointer leave room for the mNumButtons of EncodedButtonConfig.
+    const uint8_t* const mPins;
+    uint8_t const mNumPins;
+    uint8_t const mAnyPressedPin;
+
+    /**
+     * Set by checkButtons() when all buttons were idle (see
+     * AceButton::isIdle()) and the virtual pin was settled at "no button".
+     */
+    bool mAllIdle = false;
+};
 
 /**
  * A ButtonConfig that handles an N-to-M binary encoder where N = 2^M. This is a
@@ -68,7 +153,7 @@ class AceButton;
  *
  * @endcode
  */
-class EncodedButtonConfig : public ButtonConfig {
+class EncodedButtonConfig : public EncodedButtonConfigBase {
   public:
 
     /**
@@ -88,41 +173,27 @@ class EncodedButtonConfig : public ButtonConfig {
      *        configure wiring of the virtual button, so that it matches the
      *        wiring of the physical buttons. The LS74148 encoder uses a pull-up
      *        wiring, so this should be set HIGH. The default value is HIGH.
+     * @param anyPressedPin optional pin which becomes active (i.e. has the
+     *        same pressed state as the encoder pins) when any button is
+     *        pressed, for example, the GS (group select) output of the 74LS148
+     *        encoder. If given, checkButtons() reads only this pin, and skips
+     *        the processing of the buttons, as long as no button is pressed
+     *        and no button has a pending timer (e.g. an orphaned click). The
+     *        default value is kNoPin which disables this optimization.
      */
     EncodedButtonConfig(uint8_t numPins, const uint8_t pins[],
-        uint8_t numButtons, AceButton* const buttons[],
-        uint8_t defaultReleasedState = HIGH);
-
-    /**
-     * Return state of the virtual (i.e. encoded) 'pin' number, corresponding to
-     * the pull-down states of the actual pins. LOW means that the corresponding
-     * encoded virtual pin was pushed.
-     *
-     * This method is not expected to be used. Use the checkButtons() method
-     * instead for this class.
-     */
-    int readButton(uint8_t pin) override;
+        PinType numButtons, AceButton* const buttons[],
+        uint8_t defaultReleasedState = HIGH,
+        uint8_t anyPressedPin = kNoPin);
 
     /**
-     * Read the pins once, obtain the virtual pin number, then call each
-     * button's checkState() method to trigger any events. When the number of
-     * buttons becomes greater than 7 or 8, it is more efficient to call this
-     * method, instead of calling the check() of each AceButton.
+     * Read the pins once, obtain the virtual pin number, debounce it once for
+     * all buttons, then call each button's checkDebouncedState() method with
+     * the settled value to trigger any events. When the number of buttons
+     * becomes greater than 7 or 8, it is more efficient to call this method,
+     * instead of calling the check() of each AceButton.
      */
-    void checkButtons() const;
-
-    /** The virtual button pin number corresponding to "no button" pressed. */
-    uint8_t getNoButtonPin() const {
-      return 0;
-    }
-
-  protected:
-    /**
-     * Return the virtual pin number corresponding to the combinatorial states
-     * of the actual pins. Returns a number between 1 and (2^{numPins} - 1). 0
-     * means "no button" pressed.
-     */
-    virtual uint8_t getVirtualPin() const;
+    void checkButtons();
 
   private:
     // Disable copy-constructor and assignment operator
@@ -130,11 +201,7 @@ class EncodedButtonConfig : public ButtonConfig {
     EncodedButtonConfig& operator=(const EncodedButtonConfig&) = delete;
 
   private:
-    // Arranged for efficient packing on 32-bit processors
-    uint8_t const mNumPins;
-    uint8_t const mNumButtons;
-    uint8_t const mPressedState;
-    const uint8_t* const mPins;
+    PinType const mNumButtons;
     AceButton* const* const mButtons;
 };
 
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_ENCODED_BUTTON_CONFIG_N_H
+#define ACE_BUTTON_ENCODED_BUTTON_CONFIG_N_H
+
+#include "EncodedButtonConfig.h"
+#include "OwnedButton.h" // OwnedButtonConfig
+
+namespace ace_button {
+
+/**
+ * A variant of EncodedButtonConfig which owns its N buttons in a contiguous
+ * array, instead of referencing separately created AceButton instances through
+ * an array of pointers. This saves one pointer per button (2 bytes on AVR, 4
+ * bytes on 32-bit processors), and removes one memory load per button in
+ * checkButtons(). It shares the reading and the debouncing of the virtual pin
+ * with EncodedButtonConfig through EncodedButtonConfigBase, but it is not a
+ * EncodedButtonConfig.
+ *
+ * The button at index 'i' is assigned the virtual pin 'i+1' (because virtual
+ * pin 0 means "no button pressed") and the id 'i'. Use getButton() to access
+ * the button, and AceButton::getId() in the event handler to identify it.
+ *
+ * @code
+ * static const uint8_t PINS[] = {2, 3, 4, 5};
+ * static EncodedButtonConfigN<15> buttonConfig(4, PINS);
+ *
+ * void loop() {
+ *   buttonConfig.checkButtons();
+ * }
+ * @endcode
+ *
+ * @tparam N number of buttons, at most (2^numPins - 1)
+ */
+template <PinType N>
+class EncodedButtonConfigN :
+    public internal::OwnedButtonConfig<EncodedButtonConfigBase, N> {
+  public:
+    /**
+     * Constructor. The parameters are identical to the EncodedButtonConfig
+     * constructor, except that the buttons are created internally.
+     */
+    EncodedButtonConfigN(uint8_t numPins, const uint8_t pins[],
+        uint8_t defaultReleasedState = HIGH,
+        uint8_t anyPressedPin = ButtonConfig::kNoPin):
+      internal::OwnedButtonConfig<EncodedButtonConfigBase, N>(numPins, pins,
+          defaultReleasedState, anyPressedPin) {}
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "AceButton.h"
+#include "FlightRecorder.h"
+
+namespace ace_button {
+
+void FlightRecorder::printTo(Print& printer) const {
+  printer.println(F("time,id,event,state"));
+  for (uint16_t i = 0; i < getCount(); i++) {
+    const FlightRecord& record = getRecord(i);
+    printer.print(record.time);
+    printer.print(',');
+    printer.print(record.id);
+    printer.print(',');
+    printer.print(AceButton::eventName(record.getEventType()));
+    printer.print(',');
+    printer.println(record.getButtonState());
+  }
+}
+
+}
@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_FLIGHT_RECORDER_H
+#define ACE_BUTTON_FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include "PinType.h" // IdType
+
+/**
+ * Set to 1 to add ButtonConfig::setFlightRecorder(), which records every event
+ * of the buttons in a FlightRecorder. This must be set in the build flags of
+ * the whole project (e.g. -D ACE_BUTTON_FLIGHT_RECORDER=1) so that the library
+ * and the application see the same layout of ButtonConfig. When set to 0 (the
+ * default), the FlightRecorder can still be used by calling record() directly.
+ */
+#if ! defined(ACE_BUTTON_FLIGHT_RECORDER)
+  #define ACE_BUTTON_FLIGHT_RECORDER 0
+#endif
+
+namespace ace_button {
+
+/**
+ * A compact record of an event: 4 bytes, or 6 bytes when ACE_BUTTON_WIDE_PINS
+ * is enabled.
+ */
+struct FlightRecord {
+  /** Return the event type (e.g. AceButton::kEventPressed). */
+  uint8_t getEventType() const { return eventAndState >> 1; }
+
+  /** Return the button state (LOW or HIGH) given to the event handler. */
+  uint8_t getButtonState() const { return eventAndState & 0x1; }
+
+  /** The lower 16 bits of ButtonConfig::getClock() of the event. */
+  uint16_t time;
+
+  /** The AceButton::getId() of the button. */
+  IdType id;
+
+  /** The event type in the upper 7 bits, the button state in the lowest bit. */
+  uint8_t eventAndState;
+};
+
+/**
+ * The position of the FlightRecorder in its ring of records. It is stored next
+ * to the records, so that both survive a reset of the processor when they are
+ * placed in a section of RAM which is not initialized at startup.
+ */
+struct FlightLogHeader {
+  /** kMagic if the header and the records are valid. */
+  uint16_t magic;
+
+  /** Index of the next record to write. */
+  uint16_t next;
+
+  /** Number of valid records. */
+  uint16_t count;
+};
+
+/**
+ * The buffer of a FlightRecorder with a capacity of N records, provided by the
+ * application. To preserve the records across a reset, place it in a section
+ * of RAM which is not initialized at startup, for example:
+ *
+ * @code
+ * FlightLog<32> flightLog __attribute__((section(".noinit"))); // AVR
+ * @endcode
+ */
+template <uint16_t N>
+struct FlightLog {
+  static_assert(N > 0, "N must be > 0");
+
+  FlightLogHeader header;
+  FlightRecord records[N];
+};
+
+/**
+ * A flight recorder which keeps the last N events of the buttons in a ring
+ * buffer provided by the application, to find out what the buttons did before
+ * a crash or a reset. Recording is O(1) and never allocates memory.
+ *
+ * If ACE_BUTTON_FLIGHT_RECORDER is enabled, ButtonConfig::setFlightRecorder()
+ * records every event of the buttons of a ButtonConfig, just before it is
+ * given to the event handler. Otherwise, record() can be called by the event
+ * handler.
+ */
+class FlightRecorder {
+  public:
+    /** Value of FlightLogHeader::magic of a valid log. */
+    static const uint16_t kMagic = 0xF1E3;
+
+    /**
+     * Constructor. The records of the log are kept if the header of the log is
+     * valid, which is normally the case after a reset if the log is in
+     * non-initialized RAM. Otherwise (e.g. after a power on), the log is
+     * cleared.
+     */
+    template <uint16_t N>
+    explicit FlightRecorder(FlightLog<N>& log):
+        mHeader(log.header),
+        mRecords(log.records),
+        mCapacity(N) {
+      if (mHeader.magic != kMagic
+          || mHeader.next >= mCapacity
+          || mHeader.count > mCapacity) {
+        clear();
+      }
+    }
+
+    /** Remove all records. */
+    void clear() {
+      mHeader.magic = kMagic;
+      mHeader.next = 0;
+      mHeader.count = 0;
+    }
+
+    /** Record an event, overwriting the oldest record if the log is full. */
+    void record(uint16_t time, IdType id, uint8_t eventType,
+        uint8_t buttonState) {
+      FlightRecord& record = mRecords[mHeader.next];
+      record.time = time;
+      record.id = id;
+      record.eventAndState = (eventType << 1) | (buttonState & 0x1);
+      mHeader.next = (mHeader.next + 1 == mCapacity) ? 0 : mHeader.next + 1;
+      if (mHeader.count < mCapacity) mHeader.count++;
+    }
+
+    /** Return the maximum number of records. */
+    uint16_t getCapacity() const { return mCapacity; }
+
+    /** Return the number of records. */
+    uint16_t getCount() const { return mHeader.count; }
+
+    /** Return the i-th record, where 0 is the oldest record. */
+    const FlightRecord& getRecord(uint16_t i) const {
+      uint32_t index = (uint32_t) mHeader.next + mCapacity - mHeader.count + i;
+      if (index >= mCapacity) index -= mCapacity;
+      return mRecords[index];
+    }
+
+    /**
+     * Print the records from the oldest to the newest, one per line, in the
+     * CSV format "time,id,event,state", preceded by a header line. The event
+     * is printed using AceButton::eventName().
+     */
+    void printTo(Print& printer) const;
+
+  private:
+    // Disable copy-constructor and assignment operator
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    FlightLogHeader& mHeader;
+    FlightRecord* const mRecords;
+    uint16_t const mCapacity;
+};
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_HANDLER_WATCHDOG_H
+#define ACE_BUTTON_HANDLER_WATCHDOG_H
+
+#include <string.h> // memset()
+#include <Arduino.h>
+
+/**
+ * Set to 1 to measure the execution time of every call to the event handler
+ * of a ButtonConfig, and to call a user-defined function when a call exceeds
+ * its time budget. This must be set in the build flags of the whole project
+ * (e.g. -D ACE_BUTTON_HANDLER_WATCHDOG=1) so that the library and the
+ * application see the same layout of ButtonConfig. When set to 0 (the
+ * default), nothing is measured, and the code is not compiled.
+ */
+#if ! defined(ACE_BUTTON_HANDLER_WATCHDOG)
+  #define ACE_BUTTON_HANDLER_WATCHDOG 0
+#endif
+
+namespace ace_button {
+
+class AceButton;
+
+/**
+ * Execution time of the event handler of a ButtonConfig, collected when
+ * ACE_BUTTON_HANDLER_WATCHDOG is enabled. A slow event handler delays the
+ * processing of every button which is checked after it, so it can cause missed
+ * or late events.
+ */
+struct HandlerStats {
+  /** Number of calls to the event handler which were measured. */
+  uint32_t count;
+
+  /** Number of calls which took more than the budget. */
+  uint32_t overBudget;
+
+  /** Longest execution time in microseconds. */
+  uint32_t maxMicros;
+
+  /** AceButton::getId() of the button of the longest call. */
+  uint16_t worstId;
+
+  /** Event type of the longest call. */
+  uint8_t worstEventType;
+
+  /** Set all fields to 0. */
+  void reset() {
+    memset(this, 0, sizeof(*this));
+  }
+};
+
+/**
+ * Signature of the function called when a call to the event handler takes
+ * more than the budget set by ButtonConfig::setHandlerBudget().
+ *
+ * @param button the AceButton which generated the event
+ * @param eventType the event type given to the event handler
+ * @param elapsedMicros the execution time of the event handler
+ */
+typedef void (*BudgetExceededHandler)(AceButton* button, uint8_t eventType,
+    uint32_t elapsedMicros);
+
+}
+
+#endif
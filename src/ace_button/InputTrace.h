@@ -0,0 +1,256 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_INPUT_TRACE_H
+#define ACE_BUTTON_INPUT_TRACE_H
+
+#include <string.h> // memcpy()
+#include <Arduino.h>
+#include "ButtonConfig.h" // PinType
+
+namespace ace_button {
+
+/**
+ * A change of the level of an input pin, read from an input trace by
+ * InputTraceReader.
+ */
+struct InputEvent {
+  /** Time of the change in milliseconds. */
+  uint32_t time;
+
+  /** Pin number. */
+  PinType pin;
+
+  /** New level of the pin, LOW or HIGH. */
+  uint8_t level;
+};
+
+/**
+ * Constants and helpers of the binary format of an input trace, a compact
+ * stream of (time, pin, level) records which can be captured on a device and
+ * replayed on the host (see examples/TraceReplayer).
+ *
+ * The trace starts with a 4-byte header: 'A', 'B', 'T', followed by the
+ * version number (kVersion). Each record is 2 unsigned varints (7 bits per
+ * byte, least significant group first, with the high bit set on all bytes
+ * except the last one):
+ *
+ *  * the time since the previous record (or since 0 for the first record),
+ *  * (pin << 1) | level, where the pin is the absolute pin number, not a
+ *    delta.
+ *
+ * A level change of a pin below 64 within 127 ms of the previous one takes
+ * only 2 bytes.
+ */
+class InputTrace {
+  public:
+    /** Size of the header. */
+    static const uint8_t kHeaderSize = 4;
+
+    /** Version of the format written in the header. */
+    static const uint8_t kVersion = 1;
+
+    /** Maximum size of a varint of 32 bits. */
+    static const uint8_t kMaxVarintSize = 5;
+
+    /** Maximum size of a record. */
+    static const uint8_t kMaxRecordSize = 2 * kMaxVarintSize;
+
+    /** Write the header into 'buffer', which must have kHeaderSize bytes. */
+    static void writeHeader(uint8_t* buffer) {
+      buffer[0] = 'A';
+      buffer[1] = 'B';
+      buffer[2] = 'T';
+      buffer[3] = kVersion;
+    }
+
+    /** Return true if 'buffer' of 'size' bytes starts with a valid header. */
+    static bool isValidHeader(const uint8_t* buffer, size_t size) {
+      return size >= kHeaderSize
+          && buffer[0] == 'A'
+          && buffer[1] == 'B'
+          && buffer[2] == 'T'
+          && buffer[3] == kVersion;
+    }
+
+    /**
+     * Encode 'value' into 'buffer', which must have kMaxVarintSize bytes.
+     * Return the number of bytes written.
+     */
+    static uint8_t encodeVarint(uint8_t* buffer, uint32_t value) {
+      uint8_t size = 0;
+      while (value >= 0x80) {
+        buffer[size++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+      }
+      buffer[size++] = (uint8_t) value;
+      return size;
+    }
+
+    /**
+     * Decode a varint from 'buffer' of 'size' bytes into 'value'. Return the
+     * number of bytes read, or 0 if the varint is truncated or too long.
+     */
+    static uint8_t decodeVarint(const uint8_t* buffer, size_t size,
+        uint32_t& value) {
+      value = 0;
+      for (uint8_t i = 0; i < kMaxVarintSize && i < size; i++) {
+        value |= (uint32_t) (buffer[i] & 0x7F) << (7 * i);
+        if (! (buffer[i] & 0x80)) return i + 1;
+      }
+      return 0;
+    }
+};
+
+/**
+ * Writes an input trace into a buffer provided by the application. Recording
+ * is O(1) and never allocates memory. The application usually calls record()
+ * when it sees a change of the level of a pin, for example in an override of
+ * ButtonConfig::readButton().
+ */
+class InputTraceWriter {
+  public:
+    /**
+     * Constructor. The buffer must have at least InputTrace::kHeaderSize
+     * bytes.
+     */
+    InputTraceWriter(uint8_t* buffer, size_t capacity):
+        mBuffer(buffer),
+        mCapacity(capacity) {
+      clear();
+    }
+
+    /** Remove all records, keeping the header. */
+    void clear() {
+      InputTrace::writeHeader(mBuffer);
+      mSize = InputTrace::kHeaderSize;
+      mLastTime = 0;
+      mNumRecords = 0;
+    }
+
+    /**
+     * Record a change of 'pin' to 'level' at 'time' (usually millis()). The
+     * times must not decrease. Return false, without writing anything, if the
+     * buffer is full.
+     */
+    bool record(uint32_t time, PinType pin, uint8_t level) {
+      uint8_t encoded[InputTrace::kMaxRecordSize];
+      uint8_t size = InputTrace::encodeVarint(encoded, time - mLastTime);
+      size += InputTrace::encodeVarint(
+          encoded + size, ((uint32_t) pin << 1) | (level & 0x1));
+      if (mSize + size > mCapacity) return false;
+
+      memcpy(mBuffer + mSize, encoded, size);
+      mSize += size;
+      mLastTime = time;
+      mNumRecords++;
+      return true;
+    }
+
+    /** Return the buffer which contains the trace. */
+    const uint8_t* getBuffer() const { return mBuffer; }
+
+    /** Return the size of the trace in bytes, including the header. */
+    size_t getSize() const { return mSize; }
+
+    /** Return the number of records. */
+    uint32_t getNumRecords() const { return mNumRecords; }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    InputTraceWriter(const InputTraceWriter&) = delete;
+    InputTraceWriter& operator=(const InputTraceWriter&) = delete;
+
+    uint8_t* const mBuffer;
+    size_t const mCapacity;
+    size_t mSize;
+    uint32_t mLastTime;
+    uint32_t mNumRecords;
+};
+
+/** Reads the records of an input trace written by InputTraceWriter. */
+class InputTraceReader {
+  public:
+    InputTraceReader(const uint8_t* buffer, size_t size):
+        mBuffer(buffer),
+        mSize(size) {
+      rewind();
+    }
+
+    /** Return true if the trace has a valid header. */
+    bool isValid() const {
+      return InputTrace::isValidHeader(mBuffer, mSize);
+    }
+
+    /** Restart from the first record. */
+    void rewind() {
+      mPos = InputTrace::kHeaderSize;
+      mLastTime = 0;
+    }
+
+    /**
+     * Read the next record into 'event'. Return false at the end of the trace,
+     * or if the trace is invalid or truncated, or if the pin of the record
+     * does not fit in PinType (e.g. a trace of more than 255 pins recorded
+     * with ACE_BUTTON_WIDE_PINS, read without it). Use isEnd() to tell them
+     * apart.
+     */
+    bool next(InputEvent& event) {
+      if (! isValid() || mPos >= mSize) return false;
+
+      uint32_t delta;
+      uint8_t n = InputTrace::decodeVarint(mBuffer + mPos, mSize - mPos, delta);
+      if (n == 0) return false;
+      uint32_t pinLevel;
+      uint8_t m = InputTrace::decodeVarint(
+          mBuffer + mPos + n, mSize - mPos - n, pinLevel);
+      if (m == 0) return false;
+      uint32_t pin = pinLevel >> 1;
+      if (pin != (PinType) pin) return false;
+
+      mPos += n + m;
+      mLastTime += delta;
+      event.time = mLastTime;
+      event.pin = (PinType) pin;
+      event.level = pinLevel & 0x1;
+      return true;
+    }
+
+    /** Return true if all the records of the trace have been read. */
+    bool isEnd() const { return mPos >= mSize; }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    InputTraceReader(const InputTraceReader&) = delete;
+    InputTraceReader& operator=(const InputTraceReader&) = delete;
+
+    const uint8_t* const mBuffer;
+    size_t const mSize;
+    size_t mPos;
+    uint32_t mLastTime;
+};
+
+}
+
+#endif
@@ -27,59 +27,51 @@ SOFTWARE.
 
 namespace ace_button {
 
+LadderButtonConfigBase::LadderButtonConfigBase(
+    uint8_t pin,
+    PinType numLevels,
+    const uint16_t levels[],
+    uint8_t defaultReleasedState
+):
+    VirtualPinButtonConfig(defaultReleasedState),
+    mLevels(levels),
+    mNumLevels(numLevels),
+    mPin(pin)
+{
+  // TODO: Verify that the levels[] are monotonically increasing.
+}
+
 LadderButtonConfig::LadderButtonConfig(
     uint8_t pin,
-    uint8_t numLevels,
+    PinType numLevels,
     const uint16_t levels[],
-    uint8_t numButtons,
+    PinType numButtons,
     AceButton* const buttons[],
     uint8_t defaultReleasedState
 ):
-    mPin(pin),
-    mNumLevels(numLevels),
+    LadderButtonConfigBase(pin, numLevels, levels, defaultReleasedState),
     mNumButtons(numButtons),
-    mPressedState(defaultReleasedState ^ 0x1),
-    mLevels(levels),
     mButtons(buttons)
 {
-  for (uint8_t i = 0; i < mNumButtons; i++) {
+  for (PinType i = 0; i < mNumButtons; i++) {
     AceButton* button = mButtons[i];
     button->setButtonConfig(this);
   }
-
-  // TODO: Verify that the levels[] are monotonically increasing.
 }
 
-int LadderButtonConfig::readButton(uint8_t pin) {
-  uint8_t virtualPin = getVirtualPin();
-  return (virtualPin == pin) ? mPressedState : (mPressedState ^ 0x1);
-}
-
-void LadderButtonConfig::checkButtons() const {
-  uint8_t virtualPin = getVirtualPin();
-
-  for (uint8_t i = 0; i < mNumButtons; i++) {
-    AceButton* button = mButtons[i];
-    if (button == nullptr) continue;
-
-    // For each button, call checkState() to allow it to figure out which
-    // state it should move to.
-    uint8_t buttonPin = button->getPin();
-    uint8_t buttonState = (buttonPin == virtualPin)
-        ? mPressedState : (mPressedState ^ 0x1);
-    button->checkState(buttonState);
-  }
+void LadderButtonConfig::checkButtons() {
+  checkButtonArray(mButtons, mNumButtons);
 }
 
-uint8_t LadderButtonConfig::getVirtualPin() const {
+PinType LadderButtonConfigBase::getVirtualPin() const {
   uint16_t level = analogRead(mPin);
   return extractIndex(mNumLevels, mLevels, level);
 }
 
-uint8_t LadderButtonConfig::extractIndex(uint8_t numLevels,
+PinType LadderButtonConfigBase::extractIndex(PinType numLevels,
     uint16_t const levels[], uint16_t level) {
 
-  uint8_t i;
+  PinType i;
   for (i = 0; i < numLevels - 1; i++) {
 
     // NOTE(brian): This will overflow a 16-bit ADC. If we need to support that,
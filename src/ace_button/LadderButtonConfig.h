@@ -26,18 +26,86 @@ SOFTWARE.
 #define ACE_BUTTON_LADDER_BUTTON_CONFIG_H
 
 #include "ButtonConfig.h"
+#include "AceButton.h"
+#include "VirtualPinButtonConfig.h"
 
 // Unit test
 class LadderButtonConfig_extractIndex;
 
 namespace ace_button {
 
-class AceButton;
+/**
+ * The part of LadderButtonConfig which reads and debounces the analog pin,
+ * without the array of buttons. It is the base class of LadderButtonConfig,
+ * which references its buttons through an array of pointers, and of
+ * LadderButtonConfigN, which owns its buttons.
+ */
+class LadderButtonConfigBase : public VirtualPinButtonConfig {
+  public:
+    /** The virtual pin of the first button, which is at levels[0]. */
+    static const PinType kFirstButtonPin = 0;
+
+    /** The virtual button pin number corresponding to "no button" pressed. */
+    PinType getNoButtonPin() const {
+      return mNumLevels - 1;
+    }
+
+  protected:
+    /** See LadderButtonConfig::LadderButtonConfig() for the parameters. */
+    LadderButtonConfigBase(uint8_t pin, PinType numLevels,
+        const uint16_t levels[], uint8_t defaultReleasedState);
+
+    /**
+     * Return the virtual pin number corresponding to current state of the ADC
+     * as returned by the `analogRead()` function. When no button is pressed,
+     * this returns (numLevels - 1), which does not correspond to any valid
+     * button.
+     */
+    PinType getVirtualPin() const override;
+
+    /**
+     * Implementation of checkButtons() for an array of buttons. T_BUTTON is
+     * either `AceButton* const` for the array of pointers given to the
+     * LadderButtonConfig constructor, or AceButton (or a subclass) for the
+     * contiguous array owned by LadderButtonConfigN.
+     */
+    template <typename T_BUTTON>
+    void checkButtonArray(T_BUTTON buttons[], PinType numButtons) {
+      uint16_t now = getClock();
+    #if ACE_BUTTON_POLL_MONITOR
+      recordPoll(this, now);
+    #endif
+      checkVirtualPin(now, getVirtualPin(), getNoButtonPin(),
+          buttons, numButtons);
+    }
+
+  private:
+    // Allow unit test to access extractIndex().
+    friend class ::LadderButtonConfig_extractIndex;
+
+    // Disable copy-constructor and assignment operator
+    LadderButtonConfigBase(const LadderButtonConfigBase&) = delete;
+    LadderButtonConfigBase& operator=(const LadderButtonConfigBase&) = delete;
+
+    /**
+     * Return the index of 'levels[]' which matches the given 'level'. Extracted
+     * as a static function for unit testing.
+     */
+    static PinType extractIndex(PinType numLevels, uint16_t const levels[],
+        uint16_t level);
+
+  private:
+    // Arranged for efficient packing on 32-bit processors, the bytes after
+    // the pointer leave room for the mNumButtons of LadderButtonConfig.
+    uint16_t const* const mLevels;
+    PinType const mNumLevels;
+    uint8_t const mPin;
+};
 
 /**
  * A ButtonConfig that handles multiple buttons using a resistor ladder.
  */
-class LadderButtonConfig : public ButtonConfig {
+class LadderButtonConfig : public LadderButtonConfigBase {
   public:
 
     /**
@@ -58,25 +126,19 @@ class LadderButtonConfig : public ButtonConfig {
      *        is in the released state. For a pull-up wiring, the state of the
      *        pin is HIGH when the button is released.
      */
-    LadderButtonConfig(uint8_t pin, uint8_t numLevels, const uint16_t levels[],
-        uint8_t numButtons, AceButton* const buttons[],
+    LadderButtonConfig(uint8_t pin, PinType numLevels, const uint16_t levels[],
+        PinType numButtons, AceButton* const buttons[],
         uint8_t defaultReleasedState = HIGH);
 
-    /**
-     * Return state of the button corresponding to the virtual 'pin' number.
-     * LOW means that the corresponding encoded virtual pin was pushed.
-     *
-     * This method is not expected to be used. Use the checkButtons() method
-     * instead for this class.
-     */
-    int readButton(uint8_t pin) override;
-
     /**
      * Read the single mPin once, calculate the virtual pin number of the
-     * pressed button (if any), then call each button's checkState() method to
+     * pressed button (if any), debounce it once for all buttons, then call
+     * each button's checkDebouncedState() method with the settled value to
      * trigger any events. This is more efficient than calling the check() of
      * each AceButton, which in turn, calls LadderButtonConfig::readButton() for
-     * each button.
+     * each button. Debouncing the virtual pin at this level also prevents a
+     * bounce between adjacent voltage levels from opening a debouncing window
+     * in multiple buttons.
      *
      * Warning: This method is often called from the global `loop()` function.
      * But on ESP8266, this method must not be called too quickly, otherwise it
@@ -87,44 +149,15 @@ class LadderButtonConfig : public ButtonConfig {
      * `examples/LadderButtons/LadderButtons.ino` for an example of how to do
      * that.
      */
-    void checkButtons() const;
-
-    /** The virtual button pin number corresponding to "no button" pressed. */
-    uint8_t getNoButtonPin() const {
-      return mNumLevels - 1;
-    }
-
-  protected:
-    /**
-     * Return the virtual pin number corresponding to current state of the ADC
-     * as returned by the `analogRead()` function. When no button is pressed,
-     * this returns (numLevels - 1), which does not correspond to any valid
-     * button.
-     */
-    virtual uint8_t getVirtualPin() const;
+    void checkButtons();
 
   private:
-    // Allow unit test to access extractIndex().
-    friend class ::LadderButtonConfig_extractIndex;
-
     // Disable copy-constructor and assignment operator
     LadderButtonConfig(const LadderButtonConfig&) = delete;
     LadderButtonConfig& operator=(const LadderButtonConfig&) = delete;
 
-    /**
-     * Return the index of 'levels[]' which matches the given 'level'. Extracted
-     * as a static function for unit testing.
-     */
-    static uint8_t extractIndex(uint8_t numLevels, uint16_t const levels[],
-        uint16_t level);
-
   private:
-    // Arranged for efficient packing on 32-bit processors
-    uint8_t const mPin;
-    uint8_t const mNumLevels;
-    uint8_t const mNumButtons;
-    uint8_t const mPressedState;
-    uint16_t const* const mLevels;
+    PinType const mNumButtons;
     AceButton* const* const mButtons;
 };
 
@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_LATENCY_STATS_H
+#define ACE_BUTTON_LATENCY_STATS_H
+
+#include <string.h> // memset()
+#include <Arduino.h>
+
+/**
+ * Set to 1 to collect the latency from the raw edge of a button to the
+ * dispatch of each event in a LatencyStats of every ButtonConfig. This must be
+ * set in the build flags of the whole project (e.g. -D ACE_BUTTON_LATENCY=1)
+ * so that the library and the application see the same layout of
+ * ButtonConfig. When set to 0 (the default), the histograms consume no memory,
+ * and the code which updates them is not compiled.
+ */
+#if ! defined(ACE_BUTTON_LATENCY)
+  #define ACE_BUTTON_LATENCY 0
+#endif
+
+namespace ace_button {
+
+/**
+ * Histogram of latencies in milliseconds using log2 buckets of fixed size.
+ * Bucket 0 counts the latencies of 0 ms, and bucket i (1 to 16) counts the
+ * latencies from 2^(i-1) to (2^i - 1) ms. The counts saturate at 65535
+ * instead of wrapping around.
+ */
+struct LatencyHistogram {
+  /** Number of buckets, enough for all uint16_t latencies. */
+  static const uint8_t kNumBuckets = 17;
+
+  /** Return the index of the bucket of the given latency. */
+  static uint8_t bucketOf(uint16_t latency) {
+    uint8_t bucket = 0;
+    while (latency) {
+      latency >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  /** Return the smallest latency counted in the given bucket. */
+  static uint16_t bucketMin(uint8_t bucket) {
+    return (bucket == 0) ? 0 : (uint16_t) (1U << (bucket - 1));
+  }
+
+  /** Return the largest latency counted in the given bucket. */
+  static uint16_t bucketMax(uint8_t bucket) {
+    return (uint16_t) (((uint32_t) 1 << bucket) - 1);
+  }
+
+  /** Count the given latency in its bucket. */
+  void add(uint16_t latency) {
+    uint16_t& count = counts[bucketOf(latency)];
+    if (count != 0xFFFF) count++;
+  }
+
+  /** Return the sum of the counts of all buckets. */
+  uint32_t total() const {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < kNumBuckets; i++) sum += counts[i];
+    return sum;
+  }
+
+  uint16_t counts[kNumBuckets];
+};
+
+/**
+ * Edge-to-dispatch latency histograms of a ButtonConfig, one per event type,
+ * collected when ACE_BUTTON_LATENCY is enabled. The latency of an event is the
+ * time from the first raw change of the button which started the debouncing
+ * of its last transition, to the call of ButtonConfig::dispatchEvent(). It
+ * includes the debouncing delay, the delay between 2 calls to
+ * AceButton::check(), the time spent in the event handlers of previous events,
+ * and for the Clicked event postponed by
+ * ButtonConfig::kFeatureSuppressClickBeforeDoubleClick, the double-click
+ * delay. The latency of the LongPressed and RepeatPressed events is measured
+ * from the press of the button. The HeartBeat event is not tied to a
+ * transition, and is not recorded.
+ */
+struct LatencyStats {
+  /**
+   * Number of event types with a histogram. Must be equal to
+   * AceButton::kNumEventTypes, which is checked in AceButton.h.
+   */
+  static const uint8_t kNumEventTypes = 9;
+
+  /** Record the latency of an event of the given type. */
+  void record(uint8_t eventType, uint16_t latency) {
+    if (eventType < kNumEventTypes) histograms[eventType].add(latency);
+  }
+
+  /** Set all counts to 0. */
+  void reset() {
+    memset(this, 0, sizeof(*this));
+  }
+
+  /**
+   * Print the non-empty buckets in CSV format, one per line, preceded by a
+   * header line: "event,min,max,count", where 'min' and 'max' are the bounds
+   * of the bucket in milliseconds. Intended for exporting the histograms from
+   * tests and host tools.
+   */
+  void printTo(Print& printer) const;
+
+  /** Histograms indexed by event type (e.g. AceButton::kEventPressed). */
+  LatencyHistogram histograms[kNumEventTypes];
+};
+
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_OVERSAMPLED_BUTTON_CONFIG_H
+#define ACE_BUTTON_OVERSAMPLED_BUTTON_CONFIG_H
+
+#include <Arduino.h>
+#include "ButtonConfig.h"
+
+namespace ace_button {
+
+namespace internal {
+
+/**
+ * Call 'reader' SAMPLES times in a row and return the bitwise majority vote of
+ * the returned bitmaps: a bit is set in the result if it was set in more than
+ * half of the samples. A single pin is a bitmap of 1 bit.
+ *
+ * The votes are counted with a bit-sliced counter: atLeast[j] holds the bits
+ * which were set in at least (j+1) samples so far. This counts the votes of
+ * all the bits of a port (up to the width of T) with a few AND and OR
+ * operations per sample, instead of a counter per pin.
+ *
+ * @tparam SAMPLES number of samples, odd, from 1 to 15
+ * @tparam T unsigned integer type of the bitmap
+ * @tparam READER function or functor with the signature T()
+ */
+template <uint8_t SAMPLES, typename T, typename READER>
+T majorityVote(READER reader) {
+  static_assert(SAMPLES % 2 == 1, "SAMPLES must be odd to avoid ties");
+  static_assert(SAMPLES <= 15, "SAMPLES must be at most 15");
+
+  const uint8_t kQuorum = SAMPLES / 2 + 1;
+  T atLeast[kQuorum] = {};
+  for (uint8_t i = 0; i < SAMPLES; i++) {
+    T sample = reader();
+    for (uint8_t j = kQuorum - 1; j > 0; j--) {
+      atLeast[j] |= atLeast[j - 1] & sample;
+    }
+    atLeast[0] |= sample;
+  }
+  return atLeast[kQuorum - 1];
+}
+
+}
+
+/**
+ * A ButtonConfig which reads each button SAMPLES times in a row, as fast as
+ * T_CONFIG::readButton() allows, and returns the majority vote of the samples.
+ * An EMI spike which is much shorter than the duration of the SAMPLES reads
+ * is voted out before it reaches the debouncing algorithm of AceButton, so it
+ * neither starts a debouncing cycle of its own, nor cancels the debouncing of
+ * a real change, which would delay the next event by a debouncing delay.
+ * Mechanical bounces last much longer than the oversampling, so they are still
+ * handled by the debouncing.
+ *
+ * The T_CONFIG is the class whose readButton() provides the raw samples:
+ * ButtonConfig (the default) for digitalRead(), or a user-defined subclass.
+ * Its constructors are inherited. The EncodedButtonConfig::checkButtons() and
+ * LadderButtonConfig::checkButtons() methods read their pins without calling
+ * readButton(), so they are not oversampled.
+ *
+ * For ButtonConfigFast, use OversampledButtonConfigFast (in the "fast/"
+ * directory) instead, which oversamples all its pins at once.
+ *
+ * @code
+ * OversampledButtonConfig<5> buttonConfig;
+ * AceButton button(&buttonConfig, BUTTON_PIN);
+ * @endcode
+ *
+ * @tparam SAMPLES number of samples of each read, odd, from 1 to 15
+ * @tparam T_CONFIG ButtonConfig or a subclass which provides the samples
+ */
+template <uint8_t SAMPLES, typename T_CONFIG = ButtonConfig>
+class OversampledButtonConfig : public T_CONFIG {
+  public:
+    /** Number of samples of each read. */
+    static const uint8_t kSamples = SAMPLES;
+
+    using T_CONFIG::T_CONFIG;
+
+    OversampledButtonConfig() = default;
+
+    int readButton(PinType pin) override {
+      uint8_t vote = internal::majorityVote<SAMPLES, uint8_t>(
+          [this, pin]() -> uint8_t {
+            return T_CONFIG::readButton(pin) ? 1 : 0;
+          });
+      return vote ? HIGH : LOW;
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    OversampledButtonConfig(const OversampledButtonConfig&) = delete;
+    OversampledButtonConfig& operator=(const OversampledButtonConfig&) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_OWNED_BUTTON_H
+#define ACE_BUTTON_OWNED_BUTTON_H
+
+#include "AceButton.h"
+
+namespace ace_button {
+namespace internal {
+
+/**
+ * An AceButton whose default constructor does not bind it to the system
+ * ButtonConfig, for use in the button arrays owned by LadderButtonConfigN and
+ * EncodedButtonConfigN. The default AceButton() constructor would pull in
+ * ButtonConfig::getSystemButtonConfig() even though the owning config rebinds
+ * every button to itself.
+ */
+class OwnedButton : public AceButton {
+  public:
+    OwnedButton() : AceButton((ButtonConfig*) nullptr) {}
+
+  private:
+    // Disable copy-constructor and assignment operator
+    OwnedButton(const OwnedButton&) = delete;
+    OwnedButton& operator=(const OwnedButton&) = delete;
+};
+
+/**
+ * A T_BASE (EncodedButtonConfigBase or LadderButtonConfigBase) which owns its
+ * N buttons in a contiguous array. The button at index 'i' is assigned the
+ * virtual pin (T_BASE::kFirstButtonPin + i) and the id 'i'. This is the
+ * common implementation of EncodedButtonConfigN and LadderButtonConfigN.
+ *
+ * @tparam T_BASE the config which reads and debounces the virtual pin
+ * @tparam N number of buttons
+ */
+template <typename T_BASE, PinType N>
+class OwnedButtonConfig : public T_BASE {
+  public:
+    /** Number of buttons owned by this config. */
+    static const PinType kNumButtons = N;
+
+    /** Return the button at index 'i'. */
+    AceButton& getButton(PinType i) { return mButtons[i]; }
+
+    /** Scan the owned buttons. See T_BASE::checkButtonArray(). */
+    void checkButtons() {
+      this->checkButtonArray(mButtons, N);
+    }
+
+  protected:
+    /** Pass 'args' to the constructor of T_BASE, then bind the buttons. */
+    template <typename... T_ARGS>
+    explicit OwnedButtonConfig(T_ARGS... args):
+      T_BASE(args...) {
+      for (PinType i = 0; i < N; i++) {
+        mButtons[i].init(this, T_BASE::kFirstButtonPin + i,
+            this->getDefaultReleasedState(), i);
+      }
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    OwnedButtonConfig(const OwnedButtonConfig&) = delete;
+    OwnedButtonConfig& operator=(const OwnedButtonConfig&) = delete;
+
+    OwnedButton mButtons[N];
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_PIN_TYPE_H
+#define ACE_BUTTON_PIN_TYPE_H
+
+#include <stdint.h>
+
+// Set ACE_BUTTON_WIDE_PINS to 1 (e.g. with -D ACE_BUTTON_WIDE_PINS=1 in the
+// build flags of the whole project) to use 16-bit pin numbers, ids and button
+// counts, supporting more than 255 (virtual) buttons. The default uses 8 bits
+// which saves static RAM in every AceButton.
+#if ! defined(ACE_BUTTON_WIDE_PINS)
+  #define ACE_BUTTON_WIDE_PINS 0
+#endif
+
+namespace ace_button {
+
+#if ACE_BUTTON_WIDE_PINS
+  /** Type of a (physical or virtual) pin number, or of a number of buttons. */
+  typedef uint16_t PinType;
+
+  /** Type of the user-defined identifier of an AceButton. */
+  typedef uint16_t IdType;
+#else
+  /** Type of a (physical or virtual) pin number, or of a number of buttons. */
+  typedef uint8_t PinType;
+
+  /** Type of the user-defined identifier of an AceButton. */
+  typedef uint8_t IdType;
+#endif
+
+}
+
+#endif
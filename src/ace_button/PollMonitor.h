@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_POLL_MONITOR_H
+#define ACE_BUTTON_POLL_MONITOR_H
+
+#include <string.h> // memset()
+#include <Arduino.h>
+
+/**
+ * Set to 1 to make every ButtonConfig measure the interval between 2
+ * consecutive checks of its buttons in a PollMonitor. This must be set in the
+ * build flags of the whole project (e.g. -D ACE_BUTTON_POLL_MONITOR=1) so
+ * that the library and the application see the same layout of ButtonConfig.
+ * When set to 0 (the default), nothing is measured, and the code is not
+ * compiled.
+ */
+#if ! defined(ACE_BUTTON_POLL_MONITOR)
+  #define ACE_BUTTON_POLL_MONITOR 0
+#endif
+
+namespace ace_button {
+
+/**
+ * Statistics of the intervals between 2 consecutive checks of the buttons of
+ * a ButtonConfig, in milliseconds. The debouncing algorithm requires several
+ * checks during getDebounceDelay(), so an interval longer than the debounce
+ * delay means that some other code starved the polling of the buttons. An
+ * interval longer than getClickDelay() can turn a click into a simple
+ * Pressed and Released.
+ */
+struct PollStats {
+  /** Number of intervals measured. */
+  uint32_t count;
+
+  /** Sum of the intervals, to calculate the average. */
+  uint32_t sum;
+
+  /** Number of intervals longer than ButtonConfig::getDebounceDelay(). */
+  uint32_t overDebounceDelay;
+
+  /** Number of intervals longer than ButtonConfig::getClickDelay(). */
+  uint32_t overClickDelay;
+
+  /** Shortest interval. Valid only if count > 0. */
+  uint16_t minInterval;
+
+  /** Longest interval. */
+  uint16_t maxInterval;
+
+  /** Return the average interval, or 0 if no interval was measured. */
+  uint16_t getAvgInterval() const {
+    return (count == 0) ? 0 : (uint16_t) (sum / count);
+  }
+
+  /** Set all fields to 0. */
+  void reset() {
+    memset(this, 0, sizeof(*this));
+  }
+};
+
+/**
+ * Measures the intervals between the checks of a ButtonConfig. All the buttons
+ * of a ButtonConfig are normally checked in the same loop(), so only the
+ * checks of the first source (a button, or the ButtonConfig itself for the
+ * configs which check all their buttons at once) are measured. Otherwise, the
+ * intervals between the checks of 2 buttons in the same scan would be
+ * counted.
+ *
+ * The intervals are calculated using the uint16_t 'now' of
+ * AceButton::check(), so an interval longer than the 65.536 seconds rollover
+ * cannot be detected.
+ */
+class PollMonitor {
+  public:
+    PollMonitor() = default;
+
+    /** Record a check of the given source at time 'now'. */
+    void update(const void* source, uint16_t now, uint16_t debounceDelay,
+        uint16_t clickDelay) {
+      if (mSource == nullptr) {
+        mSource = source;
+      } else if (source != mSource) {
+        return;
+      } else {
+        uint16_t interval = now - mLastTime;
+        if (mStats.count == 0 || interval < mStats.minInterval) {
+          mStats.minInterval = interval;
+        }
+        if (interval > mStats.maxInterval) mStats.maxInterval = interval;
+        mStats.count++;
+        mStats.sum += interval;
+        if (interval > debounceDelay) mStats.overDebounceDelay++;
+        if (interval > clickDelay) mStats.overClickDelay++;
+      }
+      mLastTime = now;
+    }
+
+    /** Return the statistics of the intervals. */
+    const PollStats& getStats() const { return mStats; }
+
+    /**
+     * Reset the statistics. The next check starts a new measurement, possibly
+     * of a different source.
+     */
+    void reset() {
+      mStats.reset();
+      mSource = nullptr;
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    PollMonitor(const PollMonitor&) = delete;
+    PollMonitor& operator=(const PollMonitor&) = delete;
+
+    const void* mSource = nullptr;
+    PollStats mStats = PollStats();
+    uint16_t mLastTime = 0;
+};
+
+}
+
+#endif
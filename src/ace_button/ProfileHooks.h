@@ -0,0 +1,108 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_PROFILE_HOOKS_H
+#define ACE_BUTTON_PROFILE_HOOKS_H
+
+#include <Arduino.h>
+
+/**
+ * Set to 1 to call the profileEnter() and profileExit() functions at the
+ * beginning and end of the internal functions of AceButton listed below. The
+ * application (usually a benchmark such as examples/InstructionBenchmark)
+ * must then provide the definitions of those 2 functions. When set to 0 (the
+ * default), the hooks expand to nothing, and the library is identical to one
+ * compiled without them.
+ */
+#if !defined(ACE_BUTTON_PROFILE)
+  #define ACE_BUTTON_PROFILE 0
+#endif
+
+namespace ace_button {
+
+/** Profiled function: AceButton::checkDebounced(). */
+static const uint8_t kProfileCheckDebounced = 0;
+
+/** Profiled function: AceButton::checkEvent(). */
+static const uint8_t kProfileCheckEvent = 1;
+
+/** Profiled function: AceButton::checkReleased(). */
+static const uint8_t kProfileCheckReleased = 2;
+
+/**
+ * Profiled function: ButtonConfig::dispatchEvent(), including the event
+ * handler, called through AceButton::handleEvent().
+ */
+static const uint8_t kProfileDispatchEvent = 3;
+
+/** Number of profiled functions. */
+static const uint8_t kNumProfiledFunctions = 4;
+
+#if ACE_BUTTON_PROFILE
+
+/**
+ * Called upon entry into the profiled function. Must be defined by the
+ * application when ACE_BUTTON_PROFILE is 1. Calls are properly nested, e.g.
+ * kProfileCheckReleased is entered and exited within kProfileCheckEvent.
+ */
+void profileEnter(uint8_t function);
+
+/** Called upon exit from the profiled function. */
+void profileExit(uint8_t function);
+
+namespace internal {
+
+/** Call profileEnter() and profileExit() on every return path. */
+class ProfileScope {
+  public:
+    explicit ProfileScope(uint8_t function) : mFunction(function) {
+      profileEnter(function);
+    }
+
+    ~ProfileScope() {
+      profileExit(mFunction);
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    uint8_t const mFunction;
+};
+
+}
+
+#define ACE_BUTTON_PROFILE_SCOPE(function) \
+    ace_button::internal::ProfileScope aceButtonProfileScope(function)
+
+#else
+
+#define ACE_BUTTON_PROFILE_SCOPE(function) do {} while (0)
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_TRACE_HOOKS_H
+#define ACE_BUTTON_TRACE_HOOKS_H
+
+#include <Arduino.h>
+
+/**
+ * Set to 1 to call the traceHook() function at the decision points of the
+ * state machine of AceButton listed below. The application must then provide
+ * the definition of that function, which can record the trace points in a
+ * buffer to be printed later, without changing the timing of the buttons as
+ * much as a print statement would. When set to 0 (the default), the hooks
+ * expand to nothing, and the library is identical to one compiled without
+ * them.
+ */
+#if !defined(ACE_BUTTON_TRACE)
+  #define ACE_BUTTON_TRACE 0
+#endif
+
+namespace ace_button {
+
+class AceButton;
+
+/**
+ * Trace point: a change of the raw button state started the debouncing. The
+ * detail is the raw button state.
+ */
+static const uint8_t kTraceDebounceStart = 0;
+
+/**
+ * Trace point: the debouncing period ended. The detail is the debounced
+ * button state, which may be the same as the state before the debouncing if
+ * the button bounced back.
+ */
+static const uint8_t kTraceDebounceEnd = 1;
+
+/**
+ * Trace point: a click was detected, which opened the double-click window of
+ * getDoubleClickDelay(). The detail is 0.
+ */
+static const uint8_t kTraceClickWindowEnter = 2;
+
+/**
+ * Trace point: the Clicked event was postponed by
+ * kFeatureSuppressClickBeforeDoubleClick until the double-click window closes.
+ * The detail is 0.
+ */
+static const uint8_t kTraceClickPostponed = 3;
+
+/**
+ * Trace point: the double-click window of a postponed click closed without a
+ * second click, so the Clicked event is released. The detail is 0.
+ */
+static const uint8_t kTracePostponedClickRelease = 4;
+
+/**
+ * Trace point: a click which was not followed by a second click within the
+ * double-click window was reclaimed, so that it cannot become the first half
+ * of a DoubleClicked. The detail is 0.
+ */
+static const uint8_t kTraceOrphanedClickReclaim = 5;
+
+/**
+ * Trace point: an event was suppressed. The detail is the suppressed event
+ * type:
+ *
+ *  * kEventReleased: suppressed by one of the kFeatureSuppressAfterXxx flags
+ *    (and replaced by LongReleased after a LongPressed),
+ *  * kEventClicked: the second click of a DoubleClicked, or a postponed click
+ *    cancelled by the DoubleClicked.
+ */
+static const uint8_t kTraceSuppressed = 6;
+
+/** Number of trace points. */
+static const uint8_t kNumTracePoints = 7;
+
+#if ACE_BUTTON_TRACE
+
+/**
+ * Called at each trace point. Must be defined by the application when
+ * ACE_BUTTON_TRACE is 1. It is called in the middle of AceButton::check(), so
+ * it must not call back into the button.
+ *
+ * @param button the AceButton at the trace point
+ * @param tracePoint one of the kTraceXxx constants
+ * @param now the value of ButtonConfig::getClock() used by AceButton::check()
+ * @param detail additional information, defined by each trace point
+ */
+void traceHook(const AceButton* button, uint8_t tracePoint, uint16_t now,
+    uint8_t detail);
+
+#define ACE_BUTTON_TRACE_POINT(tracePoint, now, detail) \
+    ace_button::traceHook(this, tracePoint, now, detail)
+
+#else
+
+#define ACE_BUTTON_TRACE_POINT(tracePoint, now, detail) do {} while (0)
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_VIRTUAL_PIN_BUTTON_CONFIG_H
+#define ACE_BUTTON_VIRTUAL_PIN_BUTTON_CONFIG_H
+
+#include "ButtonConfig.h"
+#include "AceButton.h"
+#include "VirtualPinDebouncer.h"
+
+namespace ace_button {
+
+/**
+ * Common base class of the ButtonConfig which read a single virtual pin number
+ * for all their buttons (EncodedButtonConfigBase and LadderButtonConfigBase).
+ * It debounces the virtual pin once, and dispatches the debounced state to
+ * each button. It does not hold the buttons, which are either referenced
+ * through an array of pointers (EncodedButtonConfig, LadderButtonConfig), or
+ * owned in a contiguous array (EncodedButtonConfigN, LadderButtonConfigN).
+ */
+class VirtualPinButtonConfig : public ButtonConfig {
+  public:
+    /**
+     * Return state of the button corresponding to the virtual 'pin' number.
+     *
+     * This method is not expected to be used. Use the checkButtons() method
+     * of the subclass instead.
+     */
+    int readButton(PinType pin) override {
+      PinType virtualPin = getVirtualPin();
+      return (virtualPin == pin) ? mPressedState : (mPressedState ^ 0x1);
+    }
+
+    /** Return the state of the buttons when they are released. */
+    uint8_t getDefaultReleasedState() const { return mPressedState ^ 0x1; }
+
+  protected:
+    explicit VirtualPinButtonConfig(uint8_t defaultReleasedState):
+      mPressedState(defaultReleasedState ^ 0x1) {}
+
+    /** Return the virtual pin number of the pressed button. */
+    virtual PinType getVirtualPin() const = 0;
+
+    /** Reset the shared debouncer of the virtual pin. Used by unit tests. */
+    void resetDebouncer() { mDebouncer.reset(); }
+
+    /**
+     * Debounce the 'rawPin' read at 'now', then call the checkDebouncedState()
+     * of each button with the debounced value. T_BUTTON is either `AceButton*
+     * const` for an array of pointers, or AceButton (or a subclass) for a
+     * contiguous array.
+     *
+     * Return true if the virtual pin is settled at 'noButtonPin' and every
+     * button is idle (see AceButton::isIdle()). The caller which ignores the
+     * return value does not pay for it, since everything is inlined.
+     */
+    template <typename T_BUTTON>
+    bool checkVirtualPin(uint16_t now, PinType rawPin, PinType noButtonPin,
+        T_BUTTON buttons[], PinType numButtons) {
+    #if ACE_BUTTON_STATS
+      ButtonStats& stats = getMutableStats();
+      stats.reads++;
+      mDebouncer.countChange(stats, now, rawPin, getDebounceDelay());
+    #endif
+    #if ACE_BUTTON_BOUNCE_STATS
+      mDebouncer.checkBounce(*this, now, rawPin);
+    #endif
+      if (! mDebouncer.update(now, rawPin, getDebounceDelay())) return false;
+      PinType virtualPin = mDebouncer.getPin();
+
+      bool allIdle = mDebouncer.isSettled(noButtonPin);
+      for (PinType i = 0; i < numButtons; i++) {
+        AceButton* button = asButton(buttons[i]);
+        if (button == nullptr) continue;
+
+        // For each button, call checkDebouncedState() to allow it to figure
+        // out which state it should move to.
+        PinType buttonPin = button->getPin();
+        uint8_t buttonState = (buttonPin == virtualPin)
+            ? mPressedState : (mPressedState ^ 0x1);
+      #if ACE_BUTTON_LATENCY
+        if (buttonState != button->getLastButtonState()) {
+          button->setEdgeTime(mDebouncer.getEdgeTime());
+        }
+      #endif
+        button->checkDebouncedState(now, buttonState);
+        allIdle = allIdle && button->isIdle();
+      }
+      return allIdle;
+    }
+
+  protected:
+    uint8_t const mPressedState;
+
+  private:
+    // Disable copy-constructor and assignment operator
+    VirtualPinButtonConfig(const VirtualPinButtonConfig&) = delete;
+    VirtualPinButtonConfig& operator=(const VirtualPinButtonConfig&) = delete;
+
+    static AceButton* asButton(AceButton* button) { return button; }
+    static AceButton* asButton(AceButton& button) { return &button; }
+
+  private:
+    VirtualPinDebouncer mDebouncer;
+};
+
+}
+
+#endif
@@ -0,0 +1,207 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_VIRTUAL_PIN_DEBOUNCER_H
+#define ACE_BUTTON_VIRTUAL_PIN_DEBOUNCER_H
+
+#include <Arduino.h>
+#include "ButtonConfig.h" // PinType, ButtonStats, recordBounce()
+
+namespace ace_button {
+
+/**
+ * Debounces the virtual pin number decoded by a ButtonConfig that multiplexes
+ * several buttons onto a set of physical pins (e.g. EncodedButtonConfig and
+ * LadderButtonConfig). All the buttons attached to such a config are driven by
+ * a single decoded signal, so it is debounced once here, and only the settled
+ * value is sent to the buttons. A change of the virtual pin opens a window of
+ * debounceDelay milliseconds, and every further change restarts it, so a
+ * virtual pin is accepted only after it has been stable for debounceDelay.
+ * Unlike the fixed window of AceButton::checkDebounced(), which accepts the
+ * level read at the end of the window, this does not accept the level of an
+ * adjacent button crossed by the voltage of a ladder while it settles. A
+ * virtual pin which never stops chattering keeps the previous debounced pin.
+ *
+ * Debouncing the decoded signal once, instead of in each AceButton, saves N-1
+ * debouncing state machines per scan. It also prevents bounces between two
+ * adjacent ladder levels (or encoder codes) from opening a debouncing window
+ * in several buttons.
+ */
+class VirtualPinDebouncer {
+  public:
+    VirtualPinDebouncer() = default;
+
+    /** Reset to the initial state where no virtual pin has been seen. */
+    void reset() {
+      mFlags = 0;
+      #if ACE_BUTTON_BOUNCE_STATS
+        mBounceMeter.reset();
+      #endif
+    }
+
+    /**
+     * Process the raw virtual pin read at time 'now'. Return true if a
+     * debounced virtual pin is available through getPin(). During a debouncing
+     * window, getPin() keeps the previously accepted virtual pin. Return false
+     * only at startup, before the first virtual pin has been accepted.
+     */
+    bool update(uint16_t now, PinType rawPin, uint16_t debounceDelay) {
+      if (mFlags & kFlagDebouncing) {
+        // A change during the window restarts it.
+        if (rawPin != mCandidatePin) {
+          mCandidatePin = rawPin;
+          mLastChangeTime = now;
+          return mFlags & kFlagDebouncedValid;
+        }
+
+        // See AceButton::checkDebounced() for the reason for the uint16_t
+        // cast.
+        uint16_t elapsedTime = now - mLastChangeTime;
+        if (elapsedTime < debounceDelay) return mFlags & kFlagDebouncedValid;
+        mFlags &= ~kFlagDebouncing;
+        mFlags |= kFlagDebouncedValid;
+        mDebouncedPin = rawPin;
+        return true;
+      }
+
+      if ((mFlags & kFlagDebouncedValid) && rawPin == mDebouncedPin) {
+        return true;
+      }
+
+      // The virtual pin changed, so open the debouncing window.
+      mFlags |= kFlagDebouncing;
+      mCandidatePin = rawPin;
+      mLastChangeTime = now;
+      #if ACE_BUTTON_LATENCY
+        mEdgeTime = now;
+      #endif
+      return mFlags & kFlagDebouncedValid;
+    }
+
+    /** Return the last debounced virtual pin. Valid only if update() is true. */
+    PinType getPin() const { return mDebouncedPin; }
+
+    /**
+     * Return true if the debounced virtual pin is equal to the given pin, and
+     * the debouncer is not in the middle of a transition (nor measuring one,
+     * if ACE_BUTTON_BOUNCE_STATS is enabled).
+     */
+    bool isSettled(PinType pin) const {
+      #if ACE_BUTTON_BOUNCE_STATS
+        if (mBounceMeter.isBouncing()) return false;
+      #endif
+      return (mFlags & (kFlagDebouncedValid | kFlagDebouncing))
+              == kFlagDebouncedValid
+          && mDebouncedPin == pin;
+    }
+
+    #if ACE_BUTTON_STATS
+      /**
+       * Update the rawChanges and bounces counters of 'stats' for the
+       * 'rawPin' about to be given to update() at time 'now', like
+       * AceButton::checkDebounced(). A change which opens a debouncing window
+       * counts as a raw change, except for the first virtual pin at startup.
+       * A window which ends on the virtual pin that was accepted before it
+       * counts as a bounce.
+       */
+      void countChange(ButtonStats& stats, uint16_t now, PinType rawPin,
+          uint16_t debounceDelay) const {
+        if (mFlags & kFlagDebouncing) {
+          uint16_t elapsedTime = now - mLastChangeTime;
+          if (rawPin == mCandidatePin
+              && elapsedTime >= debounceDelay
+              && (mFlags & kFlagDebouncedValid)
+              && rawPin == mDebouncedPin) {
+            stats.bounces++;
+          }
+        } else if ((mFlags & kFlagDebouncedValid) && rawPin != mDebouncedPin) {
+          stats.rawChanges++;
+        }
+      }
+    #endif
+
+    #if ACE_BUTTON_BOUNCE_STATS
+      /**
+       * Measure the raw changes of the virtual pin for the BounceStats of
+       * 'config', before they are debounced by update(), like
+       * AceButton::checkBounce() does for a single button. The DebounceTuner
+       * of 'config' then adjusts the debounce delay of the virtual pin.
+       */
+      void checkBounce(ButtonConfig& config, uint16_t now, PinType rawPin) {
+        if (mBounceMeter.update(now, rawPin, config.getBounceQuietTime())) {
+          config.recordBounce(mBounceMeter.getLastBounces(),
+              mBounceMeter.getLastSettleTime());
+        }
+      }
+
+      /**
+       * Return the number of bounces of the transition of the virtual pin
+       * being measured, or of the last one.
+       */
+      uint8_t getLastBounces() const { return mBounceMeter.getLastBounces(); }
+
+      /**
+       * Return the settle time in milliseconds of the transition of the
+       * virtual pin being measured, or of the last one.
+       */
+      uint16_t getLastSettleTime() const {
+        return mBounceMeter.getLastSettleTime();
+      }
+    #endif
+
+    #if ACE_BUTTON_LATENCY
+      /**
+       * Return the time of the change of the virtual pin which opened the
+       * last debouncing window, i.e. the start of the transition to the
+       * current debounced virtual pin.
+       */
+      uint16_t getEdgeTime() const { return mEdgeTime; }
+    #endif
+
+  private:
+    // Disable copy-constructor and assignment operator
+    VirtualPinDebouncer(const VirtualPinDebouncer&) = delete;
+    VirtualPinDebouncer& operator=(const VirtualPinDebouncer&) = delete;
+
+    /** A debouncing window restarted at mLastChangeTime is open. */
+    static const uint8_t kFlagDebouncing = 0x01;
+
+    /** mDebouncedPin is valid. */
+    static const uint8_t kFlagDebouncedValid = 0x02;
+
+    uint16_t mLastChangeTime = 0; // ms, last change of the virtual pin
+    #if ACE_BUTTON_LATENCY
+      uint16_t mEdgeTime = 0; // ms, change which opened the window
+    #endif
+    #if ACE_BUTTON_BOUNCE_STATS
+      BounceMeter<PinType> mBounceMeter;
+    #endif
+    PinType mDebouncedPin = 0;
+    PinType mCandidatePin = 0; // virtual pin read during the window
+    uint8_t mFlags = 0;
+};
+
+}
+
+#endif
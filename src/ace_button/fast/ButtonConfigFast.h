@@ -0,0 +1,161 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_BUTTON_CONFIG_FAST_H
+#define ACE_BUTTON_BUTTON_CONFIG_FAST_H
+
+#include "../ButtonConfig.h"
+
+namespace ace_button {
+
+namespace internal {
+
+/**
+ * Select the smallest unsigned integer type that can hold a bitmap of N
+ * pins. Using uint32_t everywhere would be wasteful on 8-bit AVR processors
+ * where most configurations have fewer than 8 buttons.
+ */
+template <bool FITS8, bool FITS16>
+struct FastPinBitmap {
+  typedef uint32_t type;
+};
+
+template <bool FITS16>
+struct FastPinBitmap<true, FITS16> {
+  typedef uint8_t type;
+};
+
+template <>
+struct FastPinBitmap<false, true> {
+  typedef uint16_t type;
+};
+
+/**
+ * Read the physical pins given by the template parameters and pack their
+ * states into a bitmap of type T, with the first pin in bit 0. C++11 does not
+ * have fold expressions, so this uses recursion instead, which the compiler
+ * inlines into a straight sequence of digitalReadFast() calls.
+ */
+template <typename T, uint8_t... PINS>
+struct FastPinReader;
+
+template <typename T>
+struct FastPinReader<T> {
+  static T read() { return 0; }
+};
+
+template <typename T, uint8_t PIN, uint8_t... REST>
+struct FastPinReader<T, PIN, REST...> {
+  static T read() {
+    return (T) ((digitalReadFast(PIN) ? 1 : 0)
+        | (FastPinReader<T, REST...>::read() << 1));
+  }
+};
+
+/**
+ * Read the physical pin at index 'pin' of the template parameters. This
+ * expands at compile-time into the same chain of comparisons as the `switch`
+ * statement of the old ButtonConfigFast3, with one digitalReadFast() per pin,
+ * and a constant pin number in each one.
+ */
+template <uint8_t... PINS>
+struct FastPinDispatcher;
+
+template <>
+struct FastPinDispatcher<> {
+  static int read(PinType /*pin*/) { return 0; }
+};
+
+template <uint8_t PIN, uint8_t... REST>
+struct FastPinDispatcher<PIN, REST...> {
+  static int read(PinType pin) {
+    if (pin == 0) return digitalReadFast(PIN);
+    return FastPinDispatcher<REST...>::read(pin - 1);
+  }
+};
+
+}
+
+/**
+ * An implementation of ButtonConfig that uses digitalReadFast() instead of
+ * digitalRead() to support an arbitrary number of buttons. The primary
+ * motivation for using digitalReadFast() in this library is the reduction of
+ * flash memory, not the improvement in performance.
+ *
+ * Each physical pin given in the template parameter list corresponds to a
+ * virtual pin number (starting with 0) which is assigned to the AceButton. For
+ * example, `ButtonConfigFast<2, 3, 7>` maps virtual pin 0 to physical pin 2,
+ * virtual pin 1 to physical pin 3, and virtual pin 2 to physical pin 7.
+ *
+ * The readButton() method dispatches to the digitalReadFast() of the physical
+ * pin through a chain of comparisons generated at compile-time from the
+ * template parameters. For 1 to 3 pins, this is the same code as the `switch`
+ * statement of the old ButtonConfigFast1, ButtonConfigFast2 and
+ * ButtonConfigFast3. A table of function pointers would need a separate
+ * function per pin, in addition to the table and the indirect call.
+ *
+ * The readAll() method reads every physical pin (again using
+ * digitalReadFast()) and returns the results as a bitmap, which can be used
+ * by code that scans an array of buttons to avoid a virtual readButton() call
+ * per button.
+ *
+ * @tparam PINS physical pins used by buttons 0 to (N-1). At most 32 pins are
+ *    supported, which is the width of the largest bitmap returned by
+ *    readAll().
+ */
+template <uint8_t... PINS>
+class ButtonConfigFast : public ButtonConfig {
+  public:
+    /** Number of physical pins managed by this config. */
+    static const uint8_t kNumPins = sizeof...(PINS);
+
+    static_assert(kNumPins > 0, "ButtonConfigFast requires at least one pin");
+    static_assert(kNumPins <= 32, "ButtonConfigFast supports at most 32 pins");
+
+    /**
+     * Type of the bitmap returned by readAll(). It is the smallest of
+     * uint8_t, uint16_t or uint32_t which holds kNumPins bits.
+     */
+    typedef typename internal::FastPinBitmap<
+        (kNumPins <= 8), (kNumPins <= 16)>::type PinBitmap;
+
+    int readButton(PinType pin) override {
+      // A single pin does not need a table lookup, and the virtual pin number
+      // is ignored for compatibility with the old ButtonConfigFast1.
+      if (kNumPins == 1) return readAll();
+
+      return internal::FastPinDispatcher<PINS...>::read(pin);
+    }
+
+    /**
+     * Read all physical pins and return a bitmap of their HIGH or LOW states.
+     * Bit 'i' holds the state of the physical pin assigned to virtual pin 'i'.
+     */
+    static PinBitmap readAll() {
+      return internal::FastPinReader<PinBitmap, PINS...>::read();
+    }
+};
+
+}
+#endif
@@ -25,25 +25,19 @@ SOFTWARE.
 #ifndef ACE_BUTTON_BUTTON_CONFIG_FAST1_H
 #define ACE_BUTTON_BUTTON_CONFIG_FAST1_H
 
-#include "../ButtonConfig.h"
+#include "ButtonConfigFast.h"
 
 namespace ace_button {
 
 /**
  * An implementation of ButtonConfig that uses digitalReadFast() instead of
- * digitalRead() to support 1 button. The primary motivation for using
- * digitalReadFast() in this library is the reduction of flash memory, not the
- * improvement in performance.
+ * digitalRead() to support 1 button. This is now an alias of the variadic
+ * ButtonConfigFast<> class, retained for backwards compatibility.
  *
  * @tparam T_PIN0 physical pin used by button 0
  */
 template <uint8_t T_PIN0>
-class ButtonConfigFast1 : public ButtonConfig {
-  public:
-    int readButton(uint8_t /*pin*/) override {
-      return digitalReadFast(T_PIN0);
-    }
-};
+using ButtonConfigFast1 = ButtonConfigFast<T_PIN0>;
 
 }
 #endif
@@ -25,40 +25,21 @@ SOFTWARE.
 #ifndef ACE_BUTTON_BUTTON_CONFIG_FAST3_H
 #define ACE_BUTTON_BUTTON_CONFIG_FAST3_H
 
-#include "../ButtonConfig.h"
+#include "ButtonConfigFast.h"
 
 namespace ace_button {
 
 /**
  * An implementation of ButtonConfig that uses digitalReadFast() instead of
- * digitalRead() to support 3 buttons. The primary motivation for using
- * digitalReadFast() in this library is the reduction of flash memory, not the
- * improvement in performance.
+ * digitalRead() to support 3 buttons. This is now an alias of the variadic
+ * ButtonConfigFast<> class, retained for backwards compatibility.
  *
  * @tparam T_PIN0 physical pin used by button 0
  * @tparam T_PIN1 physical pin used by button 1
  * @tparam T_PIN2 physical pin used by button 2
  */
 template <uint8_t T_PIN0, uint8_t T_PIN1, uint8_t T_PIN2>
-class ButtonConfigFast3 : public ButtonConfig {
-  public:
-    int readButton(uint8_t pin) override {
-      switch (pin) {
-        case 0:
-          return digitalReadFast(T_PIN0);
-          break;
-        case 1:
-          return digitalReadFast(T_PIN1);
-          break;
-        case 2:
-          return digitalReadFast(T_PIN2);
-          break;
-        default:
-          return 0;
-          break;
-      }
-    }
-};
+using ButtonConfigFast3 = ButtonConfigFast<T_PIN0, T_PIN1, T_PIN2>;
 
 }
 #endif
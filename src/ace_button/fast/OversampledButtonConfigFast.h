@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_OVERSAMPLED_BUTTON_CONFIG_FAST_H
+#define ACE_BUTTON_OVERSAMPLED_BUTTON_CONFIG_FAST_H
+
+#include "../OversampledButtonConfig.h"
+#include "ButtonConfigFast.h"
+
+namespace ace_button {
+
+/**
+ * A ButtonConfigFast which oversamples all of its pins at once. The
+ * readAllOversampled() method calls readAll() SAMPLES times in a row and
+ * returns the bitwise majority vote of the bitmaps, so the cost of the voting
+ * is shared by all the pins instead of being paid for each button.
+ *
+ * The readButton() method returns the state of the pin from a snapshot taken
+ * by readAllOversampled(). A new snapshot is taken when a pin is read a second
+ * time since the last snapshot, so a loop() which calls AceButton::check() on
+ * each of N buttons takes one oversampled snapshot per scan, instead of N.
+ * The state of a pin is never older than the previous read of that pin.
+ *
+ * @code
+ * OversampledButtonConfigFast<5, BUTTON0_PIN, BUTTON1_PIN> buttonConfig;
+ * AceButton button0(&buttonConfig, 0);
+ * AceButton button1(&buttonConfig, 1);
+ * @endcode
+ *
+ * @tparam SAMPLES number of samples of each pin, odd, from 1 to 15
+ * @tparam PINS physical pins used by buttons 0 to (N-1)
+ */
+template <uint8_t SAMPLES, uint8_t... PINS>
+class OversampledButtonConfigFast : public ButtonConfigFast<PINS...> {
+  public:
+    typedef ButtonConfigFast<PINS...> Super;
+    typedef typename Super::PinBitmap PinBitmap;
+
+    /** Number of samples of each pin. */
+    static const uint8_t kSamples = SAMPLES;
+
+    OversampledButtonConfigFast() = default;
+
+    int readButton(PinType pin) override {
+      // A single pin ignores the virtual pin number, like ButtonConfigFast.
+      if (Super::kNumPins == 1) pin = 0;
+      if (pin >= Super::kNumPins) return 0;
+
+      PinBitmap mask = (PinBitmap) 1 << pin;
+      if (mServed & mask) {
+        mSnapshot = readAllOversampled();
+        mServed = 0;
+      }
+      mServed |= mask;
+      return (mSnapshot & mask) ? HIGH : LOW;
+    }
+
+    /**
+     * Read all physical pins SAMPLES times and return the bitmap of the
+     * majority vote of each pin. Bit 'i' holds the state of virtual pin 'i'.
+     */
+    static PinBitmap readAllOversampled() {
+      return internal::majorityVote<SAMPLES, PinBitmap>(&Super::readAll);
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    OversampledButtonConfigFast(const OversampledButtonConfigFast&) = delete;
+    OversampledButtonConfigFast& operator=(const OversampledButtonConfigFast&)
+        = delete;
+
+    /** Majority vote of the last readAllOversampled(). */
+    PinBitmap mSnapshot = 0;
+
+    /** Pins read from mSnapshot. Initially all set, to take a snapshot. */
+    PinBitmap mServed = (PinBitmap) ~(PinBitmap) 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_BOUNCE_GENERATOR_H
+#define ACE_BUTTON_BOUNCE_GENERATOR_H
+
+#include <stdint.h>
+
+namespace ace_button {
+namespace testing {
+
+/**
+ * Parameters of the noise model of a mechanical contact used by
+ * BounceGenerator. All times are in milliseconds. The default model is an
+ * ideal contact without any noise.
+ */
+struct BounceModel {
+  /**
+   * Maximum number of bounces after each transition. The number of bounces of
+   * each transition is uniformly distributed between 0 and maxBounces, and is
+   * limited to BounceGenerator::kMaxBounces.
+   */
+  uint8_t maxBounces;
+
+  /**
+   * Duration of the bouncing. The bounces of a transition happen at uniformly
+   * distributed times within bounceTime after the transition, after which the
+   * contact is stable.
+   */
+  uint8_t bounceTime;
+
+  /**
+   * Duration of a linear ramp between the open and the closed levels, e.g.
+   * caused by the RC filter of a resistor ladder. 0 means a sharp edge.
+   */
+  uint8_t rampTime;
+
+  /**
+   * Mean interval between EMI spikes, which invert the level of the contact
+   * for spikeWidth, independently of the transitions. The intervals are
+   * uniformly distributed between 1 and (2 * spikeInterval). 0 means no
+   * spikes.
+   */
+  uint16_t spikeInterval;
+
+  /** Duration of each EMI spike. */
+  uint8_t spikeWidth;
+};
+
+/**
+ * A seeded and reproducible generator of the raw signal of a bouncing contact,
+ * for benchmarking the debouncing of the ButtonConfig classes with realistic
+ * input (see examples/DebounceBenchmark). The intended state of the contact is
+ * set by setClosed(), and the raw level is sampled by getLevel() or isClosed()
+ * at non-decreasing times. The level is an analog value between kLevelOpen and
+ * kLevelClosed, so that the ramps of a resistor ladder can be converted into
+ * an ADC value by the caller.
+ *
+ * The same seed and the same calls always generate the same signal, on all
+ * platforms.
+ */
+class BounceGenerator {
+  public:
+    /** Level of the open contact. */
+    static const uint8_t kLevelOpen = 0;
+
+    /** Level of the closed contact. */
+    static const uint8_t kLevelClosed = 255;
+
+    /** Maximum number of bounces of a single transition. */
+    static const uint8_t kMaxBounces = 15;
+
+    BounceGenerator(const BounceModel& model, uint32_t seed):
+        mModel(model) {
+      if (mModel.maxBounces > kMaxBounces) mModel.maxBounces = kMaxBounces;
+      reset(seed);
+    }
+
+    /**
+     * Restart with an open contact at time 0, and the random sequence given by
+     * 'seed'.
+     */
+    void reset(uint32_t seed) {
+      // xorshift32 gets stuck at 0.
+      mRandom = seed ? seed : 1;
+      mClosed = false;
+      mEdgeTime = 0;
+      mNumToggles = 0;
+      mSpikeStart = mModel.spikeInterval ? nextSpikeInterval() : 0;
+    }
+
+    /**
+     * Change the intended state of the contact at 'time'. Nothing happens if
+     * the state is unchanged. The bounces of the transition are generated
+     * now.
+     */
+    void setClosed(unsigned long time, bool closed) {
+      if (closed == mClosed) return;
+      mClosed = closed;
+      mEdgeTime = time;
+
+      // Each bounce toggles the contact twice, at sorted random times within
+      // the bounceTime.
+      uint8_t numBounces = nextRandom() % (mModel.maxBounces + 1);
+      mNumToggles = (mModel.bounceTime > 1) ? 2 * numBounces : 0;
+      for (uint8_t i = 0; i < mNumToggles; i++) {
+        uint8_t toggle = 1 + nextRandom() % (mModel.bounceTime - 1);
+        uint8_t j = i;
+        for (; j > 0 && mToggles[j - 1] > toggle; j--) {
+          mToggles[j] = mToggles[j - 1];
+        }
+        mToggles[j] = toggle;
+      }
+    }
+
+    /** Return the intended state of the contact. */
+    bool getClosed() const { return mClosed; }
+
+    /**
+     * Return the raw level of the contact at 'now', between kLevelOpen and
+     * kLevelClosed. The 'now' must not be less than the time of the previous
+     * call, or of the last setClosed().
+     */
+    uint8_t getLevel(unsigned long now) {
+      unsigned long elapsed = now - mEdgeTime;
+
+      // Count the bounces which have happened since the transition.
+      bool bounced = false;
+      for (uint8_t i = 0; i < mNumToggles && mToggles[i] <= elapsed; i++) {
+        bounced = !bounced;
+      }
+
+      uint8_t target = mClosed ? kLevelClosed : kLevelOpen;
+      uint8_t level;
+      if (bounced) {
+        level = mClosed ? kLevelOpen : kLevelClosed;
+      } else if (elapsed < mModel.rampTime) {
+        uint8_t delta = elapsed * kLevelClosed / mModel.rampTime;
+        level = mClosed ? delta : kLevelClosed - delta;
+      } else {
+        level = target;
+      }
+
+      if (mModel.spikeInterval) {
+        // Skip the spikes which are over.
+        while ((long) (now - mSpikeStart) >= (long) mModel.spikeWidth) {
+          mSpikeStart += mModel.spikeWidth + nextSpikeInterval();
+        }
+        if ((long) (now - mSpikeStart) >= 0) {
+          level = kLevelClosed - level;
+        }
+      }
+      return level;
+    }
+
+    /** Return true if the raw level at 'now' is closer to closed than open. */
+    bool isClosed(unsigned long now) {
+      return getLevel(now) > kLevelClosed / 2;
+    }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    BounceGenerator(const BounceGenerator&) = delete;
+    BounceGenerator& operator=(const BounceGenerator&) = delete;
+
+    /** Return the next number of the xorshift32 generator. */
+    uint32_t nextRandom() {
+      mRandom ^= mRandom << 13;
+      mRandom ^= mRandom >> 17;
+      mRandom ^= mRandom << 5;
+      return mRandom;
+    }
+
+    uint32_t nextSpikeInterval() {
+      return 1 + nextRandom() % (2 * (uint32_t) mModel.spikeInterval);
+    }
+
+    BounceModel mModel;
+    uint32_t mRandom;
+    unsigned long mEdgeTime;
+    unsigned long mSpikeStart;
+    uint8_t mToggles[2 * kMaxBounces];
+    uint8_t mNumToggles;
+    bool mClosed;
+};
+
+}
+}
+#endif
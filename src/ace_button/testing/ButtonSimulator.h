@@ -0,0 +1,180 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_BUTTON_SIMULATOR_H
+#define ACE_BUTTON_BUTTON_SIMULATOR_H
+
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+
+namespace ace_button {
+namespace testing {
+
+/**
+ * A discrete-event simulator of a set of AceButton attached to the same
+ * TestableButtonConfig. Instead of advancing the fake clock in fixed steps and
+ * calling check() at every step, advanceTo() asks each button for the time of
+ * its next timer deadline (AceButton::getTimeToNextTimer()), and jumps the
+ * clock directly to the earliest one, until the target time is reached. The
+ * buttons are checked at exactly the same times that a fixed 1 ms polling
+ * would have dispatched an event, so the events are identical, but a long
+ * press of a minute takes a few hundred checks instead of 60000.
+ *
+ * The input of each button is held by the simulator and given to
+ * AceButton::checkState(), so that each button can have a different state. The
+ * ButtonConfig::readButton() of the TestableButtonConfig is not used.
+ *
+ * Usage:
+ *
+ * @verbatim
+ * AceButton* buttons[] = {&button0, &button1};
+ * ButtonSimulator simulator(&testableConfig, buttons, 2);
+ *
+ * simulator.reset(0);
+ * simulator.pressButton(0, 100);
+ * simulator.releaseButton(0, 150);
+ * simulator.advanceTo(600000);
+ * @endverbatim
+ */
+class ButtonSimulator {
+  public:
+    /** Maximum number of buttons supported by the simulator. */
+    static const uint8_t kMaxButtons = 16;
+
+    /**
+     * Constructor. The 'buttons' array must remain valid for the lifetime of
+     * this object. At most kMaxButtons buttons are simulated.
+     */
+    ButtonSimulator(
+        TestableButtonConfig* testableConfig,
+        AceButton* const* buttons,
+        uint8_t numButtons):
+      mTestableConfig(testableConfig),
+      mButtons(buttons),
+      mNumButtons((numButtons > kMaxButtons) ? kMaxButtons : numButtons) {}
+
+    /**
+     * Set the clock to 'now', set the input of every button to its default
+     * released state, and check every button once. The buttons are not
+     * reinitialized, so AceButton::init() should be called before if needed.
+     */
+    void reset(unsigned long now) {
+      mNow = now;
+      mNumSteps = 0;
+      for (uint8_t i = 0; i < mNumButtons; i++) {
+        mStates[i] = mButtons[i]->getDefaultReleasedState();
+      }
+      checkAll();
+    }
+
+    /**
+     * Advance the clock to 'time', then set the input of the button at
+     * 'index' to the given state and check it.
+     */
+    void setButtonState(uint8_t index, uint8_t state, unsigned long time) {
+      advanceTo(time);
+      if (index >= mNumButtons) return;
+      mStates[index] = state;
+      mButtons[index]->checkState(state);
+    }
+
+    /** Press the button at 'index' at the given time. */
+    void pressButton(uint8_t index, unsigned long time) {
+      if (index >= mNumButtons) return;
+      uint8_t released = mButtons[index]->getDefaultReleasedState();
+      setButtonState(index, (released == HIGH) ? LOW : HIGH, time);
+    }
+
+    /** Release the button at 'index' at the given time. */
+    void releaseButton(uint8_t index, unsigned long time) {
+      if (index >= mNumButtons) return;
+      setButtonState(index, mButtons[index]->getDefaultReleasedState(), time);
+    }
+
+    /**
+     * Advance the clock to 'time', checking all the buttons at each timer
+     * deadline along the way. The inputs of the buttons do not change.
+     * Nothing happens if 'time' is in the past.
+     */
+    void advanceTo(unsigned long time) {
+      if ((long) (time - mNow) <= 0) return;
+      while (true) {
+        unsigned long next = mNow + getTimeToNextTimer();
+        // A deadline which has already expired was handled by the last check.
+        if (next == mNow) next++;
+        if ((long) (next - time) > 0) break;
+        mNow = next;
+        checkAll();
+      }
+      mNow = time;
+      mTestableConfig->setClock(mNow);
+    }
+
+    /** Return the current time of the simulation. */
+    unsigned long getNow() const { return mNow; }
+
+    /** Return the input state of the button at 'index'. */
+    uint8_t getButtonState(uint8_t index) const { return mStates[index]; }
+
+    /**
+     * Return the number of times that all the buttons were checked at a timer
+     * deadline since reset().
+     */
+    uint32_t getNumSteps() const { return mNumSteps; }
+
+  private:
+    // Disable copy-constructor and assignment operator
+    ButtonSimulator(const ButtonSimulator&) = delete;
+    ButtonSimulator& operator=(const ButtonSimulator&) = delete;
+
+    /** Check all the buttons at the current time. */
+    void checkAll() {
+      mTestableConfig->setClock(mNow);
+      mNumSteps++;
+      for (uint8_t i = 0; i < mNumButtons; i++) {
+        mButtons[i]->checkState(mStates[i]);
+      }
+    }
+
+    /** Return the time until the earliest deadline of all the buttons. */
+    uint16_t getTimeToNextTimer() const {
+      uint16_t next = 0xFFFF;
+      for (uint8_t i = 0; i < mNumButtons; i++) {
+        uint16_t remaining = mButtons[i]->getTimeToNextTimer(mNow);
+        if (remaining < next) next = remaining;
+      }
+      return next;
+    }
+
+    TestableButtonConfig* const mTestableConfig;
+    AceButton* const* const mButtons;
+    uint8_t const mNumButtons;
+    uint8_t mStates[kMaxButtons];
+    unsigned long mNow = 0;
+    uint32_t mNumSteps = 0;
+};
+
+}
+}
+#endif
@@ -0,0 +1,59 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_CAPTURE_PRINT_H
+#define ACE_BUTTON_CAPTURE_PRINT_H
+
+#include <Arduino.h> // Print
+
+namespace ace_button {
+namespace testing {
+
+/**
+ * A Print which captures its output in a buffer, without the '\r' of
+ * println(), so that the tests can compare the output of the printTo()
+ * methods with a string. The output beyond the size of the buffer is dropped.
+ */
+class CapturePrint : public Print {
+  public:
+    size_t write(uint8_t c) override {
+      if (c == '\r') return 1;
+      if (mLength < sizeof(mBuffer) - 1) {
+        mBuffer[mLength++] = c;
+        mBuffer[mLength] = '\0';
+      }
+      return 1;
+    }
+
+    /** Return the output captured so far. */
+    const char* getCstr() const { return mBuffer; }
+
+  private:
+    char mBuffer[256] = "";
+    size_t mLength = 0;
+};
+
+}
+}
+#endif
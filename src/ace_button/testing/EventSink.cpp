@@ -0,0 +1,48 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Print.h>
+#include "EventSink.h"
+
+namespace ace_button {
+namespace testing {
+
+void EventSink::printTo(Print& printer) const {
+  printer.println(F("event,count"));
+  for (uint8_t event = 0; event < AceButton::kNumEventTypes; event++) {
+    printer.print(AceButton::eventName(event));
+    printer.print(',');
+    printer.println(mEventCounts[event]);
+  }
+  printer.println(F("pin,count"));
+  for (PinType pin = 0; pin < mNumPins; pin++) {
+    if (mPinCounts[pin] == 0) continue;
+    printer.print(pin);
+    printer.print(',');
+    printer.println(mPinCounts[pin]);
+  }
+}
+
+}
+}
@@ -0,0 +1,235 @@
+/*
+MIT License
+
+Copyright (c) 2023 Brian T. Park
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ACE_BUTTON_EVENT_SINK_H
+#define ACE_BUTTON_EVENT_SINK_H
+
+#include <Arduino.h>
+#include "../IEventHandler.h"
+#include "../AceButton.h"
+
+class Print;
+
+namespace ace_button {
+namespace testing {
+
+/** An event received by the EventSink, with the time of the fake clock. */
+struct SinkRecord {
+  /** Value of ButtonConfig::getClock() when the event was dispatched. */
+  unsigned long time;
+
+  PinType pin;
+  uint8_t eventType;
+  uint8_t buttonState;
+};
+
+/**
+ * An IEventHandler which receives an unlimited number of events, for soak tests
+ * and host benchmarks which generate thousands of events. Unlike
+ * EventTracker, which keeps the first 5 events, the EventSink keeps
+ * running counts of the events per event type and per pin, retains the last
+ * events in a ring buffer, and optionally forwards each event to a consumer
+ * function (e.g. to write them to a file, or to compare them with an
+ * expected stream). The processing of an event takes only a few increments
+ * and a copy, so that it does not distort the benchmarks.
+ *
+ * The storage of the records and the per-pin counts are provided by the
+ * subclass EventSinkN.
+ *
+ * @code
+ * static EventSinkN<64, 8> eventSink;
+ * ...
+ * buttonConfig.setIEventHandler(&eventSink);
+ * @endcode
+ */
+class EventSink: public IEventHandler {
+  public:
+    /** Function which receives each event. */
+    typedef void (*Consumer)(void* context, const SinkRecord& record);
+
+    /**
+     * Constructor.
+     *
+     * @param records ring buffer of the last events, may be nullptr if
+     *    'capacity' is 0
+     * @param capacity number of elements of 'records'
+     * @param pinCounts counters of the events of each pin, may be nullptr if
+     *    'numPins' is 0
+     * @param numPins number of elements of 'pinCounts'; the events of the
+     *    pins >= numPins are not counted per pin
+     */
+    EventSink(SinkRecord* records, uint16_t capacity,
+        uint32_t* pinCounts, PinType numPins):
+      mRecords(records),
+      mPinCounts(pinCounts),
+      mCapacity(capacity),
+      mNumPins(numPins) {
+      clear();
+    }
+
+    /** Set the consumer of each event, or nullptr to remove it. */
+    void setConsumer(Consumer consumer, void* context) {
+      mConsumer = consumer;
+      mContext = context;
+    }
+
+    /** Clear the records and the counters. The consumer is kept. */
+    void clear() {
+      mTotal = 0;
+      mHead = 0;
+      mNumRecords = 0;
+      for (uint8_t i = 0; i < AceButton::kNumEventTypes; i++) {
+        mEventCounts[i] = 0;
+      }
+      for (PinType i = 0; i < mNumPins; i++) mPinCounts[i] = 0;
+    }
+
+    void handleEvent(AceButton* button, uint8_t eventType,
+        uint8_t buttonState) override {
+      SinkRecord record;
+      record.time = button->getButtonConfig()->getClock();
+      record.pin = button->getPin();
+      record.eventType = eventType;
+      record.buttonState = buttonState;
+      addEvent(record);
+    }
+
+    /** Add an event, as if it was received by handleEvent(). */
+    void addEvent(const SinkRecord& record) {
+      mTotal++;
+      if (record.eventType < AceButton::kNumEventTypes) {
+        mEventCounts[record.eventType]++;
+      }
+      if (record.pin < mNumPins) mPinCounts[record.pin]++;
+
+      if (mCapacity) {
+        mRecords[mHead] = record;
+        mHead = (mHead + 1 == mCapacity) ? 0 : mHead + 1;
+        if (mNumRecords < mCapacity) mNumRecords++;
+      }
+
+      if (mConsumer) mConsumer(mContext, record);
+    }
+
+    /** Return the total number of events since clear(). */
+    uint32_t getTotal() const { return mTotal; }
+
+    /** Return the number of events of the given type since clear(). */
+    uint32_t getEventCount(uint8_t eventType) const {
+      return (eventType < AceButton::kNumEventTypes)
+          ? mEventCounts[eventType] : 0;
+    }
+
+    /**
+     * Return the number of events of the given pin since clear(), or 0 if the
+     * pin is not counted.
+     */
+    uint32_t getPinCount(PinType pin) const {
+      return (pin < mNumPins) ? mPinCounts[pin] : 0;
+    }
+
+    /** Return the number of events retained in the ring buffer. */
+    uint16_t getNumRecords() const { return mNumRecords; }
+
+    /**
+     * Return the number of events which were overwritten in the ring buffer by
+     * newer events.
+     */
+    uint32_t getOverwritten() const { return mTotal - mNumRecords; }
+
+    /**
+     * Return the i-th retained record, where 0 is the oldest. Valid only if i
+     * is less than getNumRecords().
+     */
+    const SinkRecord& getRecord(uint16_t i) const {
+      // Widened, mHead + i can overflow uint16_t when mCapacity > 32768.
+      uint32_t index = (mNumRecords < mCapacity) ? i : (uint32_t) mHead + i;
+      if (index >= mCapacity) index -= mCapacity;
+      return mRecords[index];
+    }
+
+    /**
+     * Print the counts of the events in CSV format ("event,count"), followed
+     * by the counts of each pin which has at least one event ("pin,count").
+     */
+    void printTo(Print& printer) const;
+
+  private:
+    // Disable copy-constructor and assignment operator
+    EventSink(const EventSink&) = delete;
+    EventSink& operator=(const EventSink&) = delete;
+
+    SinkRecord* const mRecords;
+    uint32_t* const mPinCounts;
+    uint16_t const mCapacity;
+    PinType const mNumPins;
+
+    Consumer mConsumer = nullptr;
+    void* mContext = nullptr;
+
+    uint32_t mTotal;
+    uint32_t mEventCounts[AceButton::kNumEventTypes];
+    uint16_t mHead;
+    uint16_t mNumRecords;
+};
+
+/**
+ * The storage of an EventSinkN. It is a separate base class, listed before
+ * EventSink, so that the arrays are constructed before the EventSink
+ * constructor clears them (the base-from-member idiom).
+ */
+template <uint16_t N_RECORDS, PinType N_PINS>
+struct EventSinkStorage {
+  // Arrays of at least one element, because zero-length arrays are not
+  // standard C++.
+  SinkRecord mRecordsStorage[N_RECORDS ? N_RECORDS : 1];
+  uint32_t mPinCountsStorage[N_PINS ? N_PINS : 1];
+};
+
+/**
+ * An EventSink which owns the ring buffer of its last N_RECORDS events, and
+ * the counters of the events of the pins 0 to N_PINS-1.
+ *
+ * @tparam N_RECORDS number of events retained, may be 0
+ * @tparam N_PINS number of pins counted, may be 0
+ */
+template <uint16_t N_RECORDS, PinType N_PINS>
+class EventSinkN:
+    private EventSinkStorage<N_RECORDS, N_PINS>,
+    public EventSink {
+  public:
+    EventSinkN():
+      EventSink(
+          EventSinkStorage<N_RECORDS, N_PINS>::mRecordsStorage, N_RECORDS,
+          EventSinkStorage<N_RECORDS, N_PINS>::mPinCountsStorage, N_PINS) {}
+
+  private:
+    // Disable copy-constructor and assignment operator
+    EventSinkN(const EventSinkN&) = delete;
+    EventSinkN& operator=(const EventSinkN&) = delete;
+};
+
+}
+}
+#endif
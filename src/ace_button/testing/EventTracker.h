@@ -26,6 +26,7 @@ SOFTWARE.
 #define ACE_BUTTON_EVENT_TRACKER_H
 
 #include <Arduino.h> // LOW
+#include "../ButtonConfig.h" // PinType
 
 namespace ace_button {
 namespace testing {
@@ -40,12 +41,12 @@ class EventRecord {
         mEventType(0),
         mButtonState(LOW) {}
 
-    EventRecord(uint8_t pin, uint8_t eventType, uint8_t buttonState):
+    EventRecord(PinType pin, uint8_t eventType, uint8_t buttonState):
         mPin(pin),
         mEventType(eventType),
         mButtonState(buttonState) {}
 
-    uint8_t getPin() const {
+    PinType getPin() const {
       return mPin;
     }
 
@@ -64,7 +65,7 @@ class EventRecord {
     EventRecord& operator=(const EventRecord&) = default;
 
   private:
-    uint8_t mPin;
+    PinType mPin;
     uint8_t mEventType;
     uint8_t mButtonState;
 };
@@ -80,7 +81,7 @@ class EventTracker {
         mNumEvents(0) {}
       
     /** Add event to a buffer of records, stopping when the buffer fills up. */
-    void addEvent(uint8_t pin, uint8_t eventType, uint8_t buttonState) {
+    void addEvent(PinType pin, uint8_t eventType, uint8_t buttonState) {
       if (mNumEvents < kMaxEvents) {
         mRecords[mNumEvents] = EventRecord(pin, eventType, buttonState);
         mNumEvents++;
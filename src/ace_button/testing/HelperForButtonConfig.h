@@ -48,7 +48,7 @@ class HelperForButtonConfig {
       mEventTracker(eventTracker) {}
 
     /** Reinitilize to its pristine state. */
-    void init(uint8_t pin, uint8_t defaultReleasedState, uint8_t id) {
+    void init(PinType pin, uint8_t defaultReleasedState, IdType id) {
       mPin = pin;
       mDefaultReleasedState = defaultReleasedState;
       mId = id;
@@ -99,9 +99,9 @@ class HelperForButtonConfig {
     AceButton* mButton;
     EventTracker* mEventTracker;
 
-    uint8_t mPin;
+    PinType mPin;
     uint8_t mDefaultReleasedState;
-    uint8_t mId;
+    IdType mId;
 };
 
 }
@@ -56,7 +56,7 @@ class HelperForLadderButtonConfig {
      * defaultReleasedState is determined by whether the button has a pullup
      * (HIGH) or pulldown (LOW) resistor.
      */
-    void pressButton(unsigned long time, uint8_t virtualPin) {
+    void pressButton(unsigned long time, PinType virtualPin) {
       mTestableConfig->setClock(time);
       mTestableConfig->setVirtualPin(virtualPin);
       mEventTracker->clear();
@@ -55,7 +55,14 @@ class TestableButtonConfig: public ButtonConfig {
 
     unsigned long getClock() override { return mMillis; }
 
-    int readButton(uint8_t /* pin */) override { return mButtonState; }
+    #if ACE_BUTTON_HANDLER_WATCHDOG
+      unsigned long getClockMicros() override { return mMicros; }
+
+      /** Set the time of the fake microsecond clock. */
+      void setClockMicros(unsigned long micros) { mMicros = micros; }
+    #endif
+
+    int readButton(PinType /* pin */) override { return mButtonState; }
 
     /** Set the time of the fake clock. */
     void setClock(unsigned long millis) { mMillis = millis; }
@@ -70,6 +77,9 @@ class TestableButtonConfig: public ButtonConfig {
 
     unsigned long mMillis;
     int mButtonState;
+    #if ACE_BUTTON_HANDLER_WATCHDOG
+      unsigned long mMicros = 0;
+    #endif
 };
 
 }
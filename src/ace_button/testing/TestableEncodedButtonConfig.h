@@ -31,19 +31,21 @@ namespace ace_button {
 namespace testing {
 
 /**
- * A subclass of EncodedButtonConfig which overrides getClock() and
- * getVirtualPin() so that their values can be controlled manually. This is
- * intended to be used for unit testing.
+ * A subclass of EncodedButtonConfig which overrides getClock(),
+ * getVirtualPin() and isAnyPressed() so that their values can be controlled
+ * manually. This is intended to be used for unit testing.
  */
 class TestableEncodedButtonConfig: public EncodedButtonConfig {
   public:
     TestableEncodedButtonConfig(uint8_t numPins, uint8_t const pins[],
-        uint8_t numButtons, AceButton* const buttons[],
+        PinType numButtons, AceButton* const buttons[],
         uint8_t defaultReleasedState = HIGH):
       EncodedButtonConfig(numPins, pins, numButtons, buttons,
         defaultReleasedState),
       mMillis(0),
-      mVirtualPin(0) {}
+      mVirtualPin(0),
+      mNumVirtualPinReads(0),
+      mAnyPressedPinEnabled(false) {}
 
     /**
      * Initialize to its pristine state. This method is needed because AUnit
@@ -53,19 +55,39 @@ class TestableEncodedButtonConfig: public EncodedButtonConfig {
      */
     void init() {
       resetFeatures();
+      resetDebouncer();
       mMillis = 0;
       mVirtualPin = 0;
+      mNumVirtualPinReads = 0;
+      mAnyPressedPinEnabled = false;
     }
 
     unsigned long getClock() override { return mMillis; }
 
-    uint8_t getVirtualPin() const override { return mVirtualPin; }
+    PinType getVirtualPin() const override {
+      mNumVirtualPinReads++;
+      return mVirtualPin;
+    }
+
+    /**
+     * If the simulated "any pressed" pin is enabled, it is active whenever the
+     * virtual pin is not 0. Otherwise, behave as if the pin is not connected.
+     */
+    bool isAnyPressed() const override {
+      return mAnyPressedPinEnabled ? (mVirtualPin != 0) : true;
+    }
 
     /** Set the time of the fake clock. */
     void setClock(unsigned long millis) { mMillis = millis; }
 
     /** Set the virtual pin number. 0 means "no button pressed". */
-    void setVirtualPin(uint8_t pin) { mVirtualPin = pin; }
+    void setVirtualPin(PinType pin) { mVirtualPin = pin; }
+
+    /** Simulate a connected "any pressed" pin (e.g. the 74LS148 GS output). */
+    void enableAnyPressedPin(bool enable) { mAnyPressedPinEnabled = enable; }
+
+    /** Return the number of times that getVirtualPin() was called. */
+    uint16_t getNumVirtualPinReads() const { return mNumVirtualPinReads; }
 
   private:
     // Disable copy-constructor and assignment operator
@@ -74,7 +96,9 @@ class TestableEncodedButtonConfig: public EncodedButtonConfig {
       = delete;
 
     unsigned long mMillis;
-    uint8_t mVirtualPin;
+    PinType mVirtualPin;
+    mutable uint16_t mNumVirtualPinReads;
+    bool mAnyPressedPinEnabled;
 };
 
 }
@@ -38,8 +38,8 @@ namespace testing {
 class TestableLadderButtonConfig: public LadderButtonConfig {
   public:
     TestableLadderButtonConfig(
-      uint8_t pin, uint8_t numLevels, const uint16_t levels[],
-      uint8_t numButtons, AceButton* const buttons[],
+      uint8_t pin, PinType numLevels, const uint16_t levels[],
+      PinType numButtons, AceButton* const buttons[],
       uint8_t defaultReleasedState = HIGH
     ):
       LadderButtonConfig(
@@ -56,19 +56,20 @@ class TestableLadderButtonConfig: public LadderButtonConfig {
      */
     void init() {
       resetFeatures();
+      resetDebouncer();
       mMillis = 0;
       mVirtualPin = 0;
     }
 
     unsigned long getClock() override { return mMillis; }
 
-    uint8_t getVirtualPin() const override { return mVirtualPin; }
+    PinType getVirtualPin() const override { return mVirtualPin; }
 
     /** Set the time of the fake clock. */
     void setClock(unsigned long millis) { mMillis = millis; }
 
     /** Set the virtual pin number. (nLevels-1) means "no button pressed". */
-    void setVirtualPin(uint8_t pin) { mVirtualPin = pin; }
+    void setVirtualPin(PinType pin) { mVirtualPin = pin; }
 
   private:
     // Disable copy-constructor and assignment operator
@@ -77,7 +78,7 @@ class TestableLadderButtonConfig: public LadderButtonConfig {
       = delete;
 
     unsigned long mMillis;
-    uint8_t mVirtualPin;
+    PinType mVirtualPin;
 };
 
 }
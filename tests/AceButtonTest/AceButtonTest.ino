@@ -136,7 +136,10 @@ test(eventName) {
       AceButton::eventName(AceButton::kEventLongReleased), "LongReleased");
   assertEqual(
       AceButton::eventName(AceButton::kEventHeartBeat), "HeartBeat");
-  assertEqual(AceButton::eventName(8), "(unknown)");
+  assertEqual(
+      AceButton::eventName(AceButton::kEventClickRetracted),
+      "ClickRetracted");
+  assertEqual(AceButton::eventName(9), "(unknown)");
   assertEqual(AceButton::eventName(255), "(unknown)");
 }
 
@@ -1223,6 +1226,77 @@ test(suppress_click_before_double_click) {
   assertEqual(HIGH, eventTracker.getRecord(0).getButtonState());
 }
 
+// Test that kFeatureSpeculativeClick dispatches the first Clicked immediately,
+// then retracts it just before the DoubleClicked. It takes precedence over
+// kFeatureSuppressClickBeforeDoubleClick.
+test(speculative_click_before_double_click) {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  const unsigned long BASE_TIME = 65500;
+
+  // reset the button
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.setFeature(ButtonConfig::kFeatureDoubleClick);
+  testableConfig.setFeature(ButtonConfig::kFeatureSpeculativeClick);
+  testableConfig.setFeature(
+      ButtonConfig::kFeatureSuppressClickBeforeDoubleClick);
+
+  // initial button state
+  helper.releaseButton(BASE_TIME + 0);
+  helper.releaseButton(BASE_TIME + 50);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // generate first click
+  helper.pressButton(BASE_TIME + 140);
+  helper.pressButton(BASE_TIME + 190);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+
+  // The Clicked is sent right away, not postponed.
+  helper.releaseButton(BASE_TIME + 300);
+  helper.releaseButton(BASE_TIME + 350);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(HIGH, eventTracker.getRecord(0).getButtonState());
+  assertEqual(+AceButton::kEventReleased,
+      eventTracker.getRecord(1).getEventType());
+
+  // generate second click within 400 ms for a double click
+  helper.pressButton(BASE_TIME + 500);
+  helper.pressButton(BASE_TIME + 550);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+
+  // Should get (ClickRetracted, DoubleClicked, Released).
+  helper.releaseButton(BASE_TIME + 650);
+  helper.releaseButton(BASE_TIME + 700);
+  assertEqual(3, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventClickRetracted,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(HIGH, eventTracker.getRecord(0).getButtonState());
+  assertEqual(+AceButton::kEventDoubleClicked,
+      eventTracker.getRecord(1).getEventType());
+  assertEqual(+AceButton::kEventReleased,
+      eventTracker.getRecord(2).getEventType());
+
+  // A third click is a new speculative Clicked, not another DoubleClicked.
+  helper.pressButton(BASE_TIME + 900);
+  helper.pressButton(BASE_TIME + 950);
+  helper.releaseButton(BASE_TIME + 1050);
+  helper.releaseButton(BASE_TIME + 1100);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(+AceButton::kEventReleased,
+      eventTracker.getRecord(1).getEventType());
+
+  // Nothing is sent when the double-click delay expires.
+  helper.checkTime(BASE_TIME + 1500);
+  assertEqual(0, eventTracker.getNumEvents());
+}
+
 // ------------------------------------------------------------------
 // LongPress tests
 // ------------------------------------------------------------------
@@ -0,0 +1,148 @@
+#line 2 "BounceGeneratorTest.ino"
+
+// Verify the noise models of the BounceGenerator.
+
+#include <AUnit.h>
+#include <ace_button/testing/BounceGenerator.h>
+
+using namespace aunit;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+// Return the number of changes of the raw state between 'start' and 'end'.
+static uint16_t countChanges(BounceGenerator& generator,
+    unsigned long start, unsigned long end) {
+  uint16_t changes = 0;
+  bool previous = generator.isClosed(start);
+  for (unsigned long t = start + 1; t < end; t++) {
+    bool closed = generator.isClosed(t);
+    if (closed != previous) changes++;
+    previous = closed;
+  }
+  return changes;
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(BounceGenerator, ideal_contact) {
+  BounceModel model = {};
+  BounceGenerator generator(model, 1);
+
+  assertFalse(generator.isClosed(0));
+  generator.setClosed(100, true);
+  assertTrue(generator.getClosed());
+  assertEqual(BounceGenerator::kLevelClosed, generator.getLevel(100));
+  assertEqual((uint16_t) 0, countChanges(generator, 100, 1000));
+  generator.setClosed(1000, false);
+  assertEqual(BounceGenerator::kLevelOpen, generator.getLevel(1000));
+}
+
+test(BounceGenerator, bounces_settle_within_bounce_time) {
+  BounceModel model = {};
+  model.maxBounces = 5;
+  model.bounceTime = 10;
+  BounceGenerator generator(model, 42);
+
+  uint16_t totalChanges = 0;
+  unsigned long time = 0;
+  for (uint8_t i = 0; i < 20; i++) {
+    time += 100;
+    bool closed = (i % 2 == 0);
+    generator.setClosed(time, closed);
+
+    // The contact takes its new state at the transition, bounces at most 5
+    // times, and is stable after 10 ms.
+    assertEqual(closed, generator.isClosed(time));
+    uint16_t changes = countChanges(generator, time, time + 10);
+    assertLessOrEqual(changes, (uint16_t) 10);
+    assertEqual((uint16_t) 0, countChanges(generator, time + 9, time + 100));
+    assertEqual(closed, generator.isClosed(time + 99));
+    totalChanges += changes;
+  }
+  assertMore(totalChanges, (uint16_t) 0);
+}
+
+test(BounceGenerator, reproducible_with_seed) {
+  BounceModel model = {};
+  model.maxBounces = 8;
+  model.bounceTime = 20;
+  model.spikeInterval = 50;
+  model.spikeWidth = 2;
+  BounceGenerator a(model, 7);
+  BounceGenerator b(model, 7);
+  BounceGenerator c(model, 8);
+
+  bool different = false;
+  for (unsigned long t = 0; t < 5000; t++) {
+    if (t % 300 == 0) {
+      a.setClosed(t, !a.getClosed());
+      b.setClosed(t, !b.getClosed());
+      c.setClosed(t, !c.getClosed());
+    }
+    assertEqual(a.getLevel(t), b.getLevel(t));
+    if (a.getLevel(t) != c.getLevel(t)) different = true;
+  }
+  assertTrue(different);
+
+  // reset() restarts the same sequence.
+  a.reset(7);
+  b.reset(7);
+  a.setClosed(10, true);
+  b.setClosed(10, true);
+  for (unsigned long t = 10; t < 100; t++) {
+    assertEqual(a.getLevel(t), b.getLevel(t));
+  }
+}
+
+test(BounceGenerator, emi_spikes) {
+  BounceModel model = {};
+  model.spikeInterval = 100;
+  model.spikeWidth = 3;
+  BounceGenerator generator(model, 3);
+
+  // Each spike inverts the open contact for 3 ms, about every 100 ms.
+  uint16_t spikeMillis = 0;
+  for (unsigned long t = 0; t < 10000; t++) {
+    if (generator.isClosed(t)) spikeMillis++;
+  }
+  uint16_t changes = countChanges(generator, 10000, 20000);
+  assertMore(spikeMillis, (uint16_t) 150);
+  assertLess(spikeMillis, (uint16_t) 450);
+  assertMore(changes, (uint16_t) 100);
+  assertLess(changes, (uint16_t) 300);
+}
+
+test(BounceGenerator, slow_ramp) {
+  BounceModel model = {};
+  model.rampTime = 10;
+  BounceGenerator generator(model, 1);
+
+  generator.setClosed(100, true);
+  uint8_t previous = generator.getLevel(100);
+  assertEqual(BounceGenerator::kLevelOpen, previous);
+  for (unsigned long t = 101; t <= 110; t++) {
+    uint8_t level = generator.getLevel(t);
+    assertMore(level, previous);
+    previous = level;
+  }
+  assertEqual(BounceGenerator::kLevelClosed, previous);
+  assertEqual((uint8_t) 127, generator.getLevel(105));
+
+  generator.setClosed(200, false);
+  assertEqual((uint8_t) 128, generator.getLevel(205));
+  assertEqual(BounceGenerator::kLevelOpen, generator.getLevel(210));
+}
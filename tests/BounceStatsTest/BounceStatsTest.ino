@@ -0,0 +1,274 @@
+#line 2 "BounceStatsTest.ino"
+
+// Verify the bounce measurements and the DebounceTuner enabled by
+// ACE_BUTTON_BOUNCE_STATS=1 (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/TestableLadderButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/CapturePrint.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+// Pressed events accumulated across the calls to the helper, which clears the
+// eventTracker before each check().
+static uint16_t numPressed;
+
+void handleEvent(AceButton* /*button*/, uint8_t eventType,
+    uint8_t /*buttonState*/) {
+  if (eventType == AceButton::kEventPressed) numPressed++;
+}
+
+// A resistor ladder of 2 buttons. The virtual pin 2 means "no button".
+static const PinType NUM_LEVELS = 3;
+static const uint16_t LEVELS[NUM_LEVELS] = {0, 512, 1023};
+static AceButton ladderButton0((uint8_t) 0);
+static AceButton ladderButton1(1);
+static AceButton* const LADDER_BUTTONS[] = {&ladderButton0, &ladderButton1};
+static TestableLadderButtonConfig ladderConfig(
+    A0, NUM_LEVELS, LEVELS, 2, LADDER_BUTTONS);
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Reset the button, the config and the stats, and set the initial released
+// state.
+static void initButton() {
+  helper.init(PIN, HIGH, BUTTON_ID);
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.setDebounceDelay(ButtonConfig::kDebounceDelay);
+  testableConfig.setBounceQuietTime(ButtonConfig::kBounceQuietTime);
+  testableConfig.disableDebounceTuner();
+  testableConfig.resetBounceStats();
+  helper.releaseButton(0);
+  helper.releaseButton(50);
+  numPressed = 0;
+}
+
+// Press the button at 'time' with 'numBounces' (even) bounces, 'interval' ms
+// apart, then keep it pressed, polling every 5 ms, until 'endTime'.
+static void bouncyPress(unsigned long time, uint8_t numBounces,
+    uint16_t interval, unsigned long endTime) {
+  helper.pressButton(time);
+  for (uint8_t i = 0; i < numBounces; i++) {
+    time += interval;
+    if (i % 2 == 0) {
+      helper.releaseButton(time);
+    } else {
+      helper.pressButton(time);
+    }
+  }
+  for (time += 5; time <= endTime; time += 5) {
+    helper.pressButton(time);
+  }
+}
+
+test(BounceStats, initial_state_is_not_a_transition) {
+  initButton();
+  helper.releaseButton(500);
+  assertEqual(0UL, testableConfig.getBounceStats().transitions);
+  assertEqual(0, button.getLastBounces());
+}
+
+test(BounceStats, measure_bounces_and_settle_time) {
+  initButton();
+
+  // Raw changes at 100, 102, 104: 2 bounces, settled after 4 ms.
+  bouncyPress(100, 2, 2, 150);
+  assertEqual(2, button.getLastBounces());
+  assertEqual(4, button.getLastSettleTime());
+
+  // The transition is recorded after 50 ms without a raw change.
+  assertEqual(0UL, testableConfig.getBounceStats().transitions);
+  helper.pressButton(154);
+  assertEqual(1UL, testableConfig.getBounceStats().transitions);
+  assertEqual(2UL, testableConfig.getBounceStats().bounces);
+  assertEqual(2, testableConfig.getBounceStats().maxBounces);
+  assertEqual(4, testableConfig.getBounceStats().maxSettleTime);
+
+  // A clean release.
+  helper.releaseButton(300);
+  helper.releaseButton(350);
+  const BounceStats& stats = testableConfig.getBounceStats();
+  assertEqual(2UL, stats.transitions);
+  assertEqual(2UL, stats.bounces);
+  assertEqual(0, button.getLastBounces());
+  assertEqual(0, button.getLastSettleTime());
+
+  CapturePrint capture;
+  stats.printTo(capture);
+  assertEqual(
+      "min,max,count\n"
+      "0,0,1\n"
+      "4,7,1\n",
+      capture.getCstr());
+}
+
+test(BounceStats, bounces_longer_than_debounce_delay) {
+  initButton();
+
+  // A worn switch bounces every 15 ms for 60 ms, which is longer than the
+  // debounce delay. It is still measured as a single transition.
+  bouncyPress(100, 4, 15, 210);
+  assertEqual(1UL, testableConfig.getBounceStats().transitions);
+  assertEqual(4, testableConfig.getBounceStats().maxBounces);
+  assertEqual(60, testableConfig.getBounceStats().maxSettleTime);
+}
+
+test(BounceStats, next_timer_ends_the_measurement) {
+  initButton();
+  helper.pressButton(100);
+  helper.pressButton(130);
+  assertEqual(20, button.getTimeToNextTimer(130));
+}
+
+test(BounceStats, short_clean_press_is_not_a_transition) {
+  initButton();
+
+  // A clean press of 30 ms returns to the released state before the input has
+  // been quiet for 50 ms, so the debounced state did not change.
+  helper.pressButton(100);
+  helper.pressButton(125);
+  helper.releaseButton(130);
+  helper.releaseButton(180);
+  assertEqual(0UL, testableConfig.getBounceStats().transitions);
+
+  // A single spike is not a transition either.
+  helper.pressButton(300);
+  helper.releaseButton(301);
+  helper.releaseButton(351);
+  assertEqual(0UL, testableConfig.getBounceStats().transitions);
+}
+
+// --------------------------------------------------------------------------
+// DebounceTuner
+// --------------------------------------------------------------------------
+
+test(DebounceTuner, update) {
+  DebounceTuner tuner;
+  assertFalse(tuner.isEnabled());
+
+  tuner.setBounds(5, 40);
+  assertTrue(tuner.isEnabled());
+
+  // Clamped to the minimum.
+  assertEqual(5, tuner.update(0));
+
+  // 16 + 16/4 + 1
+  assertEqual(21, tuner.update(16));
+  assertEqual(16, tuner.getSettleEstimate());
+
+  // A shorter settle time decays the estimate by 1/16.
+  assertEqual(19, tuner.update(2));
+  assertEqual(15, tuner.getSettleEstimate());
+
+  // Clamped to the maximum.
+  assertEqual(40, tuner.update(60));
+
+  tuner.reset();
+  assertEqual(0, tuner.getSettleEstimate());
+}
+
+test(DebounceTuner, adjusts_the_debounce_delay) {
+  initButton();
+  testableConfig.enableDebounceTuner(2, 40);
+
+  // A fast switch lowers the debounce delay.
+  bouncyPress(100, 2, 1, 160);
+  assertEqual(2, testableConfig.getDebounceTuner().getSettleEstimate());
+  assertEqual(3, testableConfig.getDebounceDelay());
+
+  // A worn switch raises it, within the bounds.
+  helper.releaseButton(200);
+  helper.releaseButton(300);
+  bouncyPress(400, 4, 10, 500);
+  assertEqual(40, testableConfig.getDebounceTuner().getSettleEstimate());
+  assertEqual(40, testableConfig.getDebounceDelay());
+
+  // Disabling the tuner keeps the current delay.
+  testableConfig.disableDebounceTuner();
+  assertFalse(testableConfig.getDebounceTuner().isEnabled());
+  assertEqual(40, testableConfig.getDebounceDelay());
+}
+
+test(DebounceTuner, short_clean_taps_keep_the_debounce_delay) {
+  initButton();
+  testableConfig.enableDebounceTuner(2, 50);
+
+  // 20 clean taps of 30 ms, polled every 5 ms, are all detected, and do not
+  // raise the debounce delay.
+  for (unsigned long start = 100; start < 100 + 20 * 200; start += 200) {
+    unsigned long time = start;
+    for (; time < start + 30; time += 5) helper.pressButton(time);
+    for (; time < start + 200; time += 5) helper.releaseButton(time);
+  }
+  assertEqual(20, numPressed);
+  assertEqual(0UL, testableConfig.getBounceStats().transitions);
+  assertEqual(ButtonConfig::kDebounceDelay, testableConfig.getDebounceDelay());
+  testableConfig.disableDebounceTuner();
+}
+
+// --------------------------------------------------------------------------
+// LadderButtonConfig
+// --------------------------------------------------------------------------
+
+/** Set the virtual pin of the ladder at 'time', and scan its buttons. */
+static void scanLadder(unsigned long time, PinType virtualPin) {
+  ladderConfig.setClock(time);
+  ladderConfig.setVirtualPin(virtualPin);
+  ladderConfig.checkButtons();
+}
+
+test(BounceStats, ladder_button_config) {
+  ladderConfig.init();
+  ladderConfig.setDebounceDelay(ButtonConfig::kDebounceDelay);
+  ladderConfig.setBounceQuietTime(ButtonConfig::kBounceQuietTime);
+  ladderConfig.resetBounceStats();
+  ladderConfig.enableDebounceTuner(2, 40);
+  scanLadder(0, 2);
+  scanLadder(50, 2);
+  assertEqual(0UL, ladderConfig.getBounceStats().transitions);
+
+  // Press button 0, which bounces into the level of button 1 at 102, and
+  // settles at 104. The virtual pin is measured once for all the buttons.
+  scanLadder(100, 0);
+  scanLadder(102, 1);
+  for (unsigned long time = 104; time <= 150; time += 2) scanLadder(time, 0);
+  assertEqual(0UL, ladderConfig.getBounceStats().transitions);
+  scanLadder(154, 0);
+  const BounceStats& stats = ladderConfig.getBounceStats();
+  assertEqual(1UL, stats.transitions);
+  assertEqual(2UL, stats.bounces);
+  assertEqual(4, stats.maxSettleTime);
+
+  // The DebounceTuner adjusts the delay of the virtual pin: 4 + 4/4 + 1.
+  assertEqual(6, ladderConfig.getDebounceDelay());
+  ladderConfig.disableDebounceTuner();
+}
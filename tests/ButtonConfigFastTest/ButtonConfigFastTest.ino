@@ -0,0 +1,129 @@
+#line 2 "ButtonConfigFastTest.ino"
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <digitalWriteFast.h>
+#include <ace_button/fast/ButtonConfigFast.h>
+#include <ace_button/fast/ButtonConfigFast1.h>
+#include <ace_button/fast/ButtonConfigFast3.h>
+#include <ace_button/fast/OversampledButtonConfigFast.h>
+
+using namespace aunit;
+using namespace ace_button;
+
+// --------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+// ButtonConfigFast
+// --------------------------------------------------------------------------
+
+// The test injects the pin values using EpoxyDuino's digitalReadValue(), so
+// it runs only under EpoxyDuino, not on actual hardware.
+#if defined(EPOXY_DUINO)
+
+static const uint8_t PIN0 = 4;
+static const uint8_t PIN1 = 5;
+static const uint8_t PIN2 = 6;
+static const uint8_t PIN3 = 7;
+static const uint8_t PIN4 = 8;
+
+static ButtonConfigFast<PIN0, PIN1, PIN2, PIN3, PIN4> fastConfig5;
+static ButtonConfigFast1<PIN2> fastConfig1;
+static ButtonConfigFast3<PIN0, PIN1, PIN2> fastConfig3;
+static OversampledButtonConfigFast<3, PIN0, PIN1, PIN2> oversampledConfig3;
+
+static void setPins(uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3,
+    uint8_t s4) {
+  digitalReadValue(PIN0, s0);
+  digitalReadValue(PIN1, s1);
+  digitalReadValue(PIN2, s2);
+  digitalReadValue(PIN3, s3);
+  digitalReadValue(PIN4, s4);
+}
+
+test(ButtonConfigFast, bitmapType) {
+  assertEqual(sizeof(uint8_t), sizeof(ButtonConfigFast<1>::PinBitmap));
+  assertEqual(sizeof(uint8_t),
+      sizeof(ButtonConfigFast<1, 2, 3, 4, 5, 6, 7, 8>::PinBitmap));
+  assertEqual(sizeof(uint16_t),
+      sizeof(ButtonConfigFast<1, 2, 3, 4, 5, 6, 7, 8, 9>::PinBitmap));
+}
+
+test(ButtonConfigFast, readButton) {
+  setPins(HIGH, LOW, HIGH, LOW, LOW);
+  assertEqual(HIGH, fastConfig5.readButton(0));
+  assertEqual(LOW, fastConfig5.readButton(1));
+  assertEqual(HIGH, fastConfig5.readButton(2));
+  assertEqual(LOW, fastConfig5.readButton(3));
+  assertEqual(LOW, fastConfig5.readButton(4));
+
+  // Out of range virtual pin
+  assertEqual(0, fastConfig5.readButton(5));
+
+  setPins(LOW, HIGH, LOW, HIGH, HIGH);
+  assertEqual(LOW, fastConfig5.readButton(0));
+  assertEqual(HIGH, fastConfig5.readButton(1));
+  assertEqual(HIGH, fastConfig5.readButton(4));
+}
+
+test(ButtonConfigFast, readAll) {
+  setPins(HIGH, LOW, HIGH, LOW, HIGH);
+  assertEqual(0x15, fastConfig5.readAll());
+
+  setPins(LOW, HIGH, LOW, HIGH, LOW);
+  assertEqual(0x0A, fastConfig5.readAll());
+}
+
+test(ButtonConfigFast, compatibleAliases) {
+  setPins(LOW, HIGH, HIGH, LOW, LOW);
+
+  // ButtonConfigFast1 ignores the virtual pin number.
+  assertEqual(HIGH, fastConfig1.readButton(0));
+  assertEqual(HIGH, fastConfig1.readButton(3));
+
+  assertEqual(LOW, fastConfig3.readButton(0));
+  assertEqual(HIGH, fastConfig3.readButton(1));
+  assertEqual(HIGH, fastConfig3.readButton(2));
+  assertEqual(0, fastConfig3.readButton(3));
+}
+
+test(OversampledButtonConfigFast, readAllOversampled) {
+  setPins(HIGH, LOW, HIGH, LOW, HIGH);
+  assertEqual(0x05, oversampledConfig3.readAllOversampled());
+
+  setPins(LOW, HIGH, HIGH, LOW, LOW);
+  assertEqual(0x06, oversampledConfig3.readAllOversampled());
+}
+
+test(OversampledButtonConfigFast, readButton_uses_one_snapshot_per_scan) {
+  setPins(HIGH, LOW, HIGH, LOW, LOW);
+  assertEqual(HIGH, oversampledConfig3.readButton(0));
+
+  // Pins 1 and 2 are read from the snapshot taken for pin 0.
+  setPins(LOW, HIGH, LOW, LOW, LOW);
+  assertEqual(LOW, oversampledConfig3.readButton(1));
+  assertEqual(HIGH, oversampledConfig3.readButton(2));
+
+  // Reading pin 0 again starts the next scan with a new snapshot.
+  assertEqual(LOW, oversampledConfig3.readButton(0));
+  assertEqual(HIGH, oversampledConfig3.readButton(1));
+  assertEqual(LOW, oversampledConfig3.readButton(2));
+
+  // Out of range virtual pin
+  assertEqual(0, oversampledConfig3.readButton(3));
+}
+
+#endif
@@ -0,0 +1,247 @@
+#line 2 "ButtonSimulatorTest.ino"
+
+// Verify that the ButtonSimulator, which jumps the fake clock to the next timer
+// deadline of the buttons, dispatches exactly the same events as a polling of
+// the buttons every millisecond.
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/ButtonSimulator.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static TestableButtonConfig testableConfig;
+static AceButton button0(&testableConfig, 2, HIGH, 0);
+static AceButton button1(&testableConfig, 3, LOW, 1);
+static AceButton* const BUTTONS[] = {&button0, &button1};
+static const uint8_t NUM_BUTTONS = 2;
+static ButtonSimulator simulator(&testableConfig, BUTTONS, NUM_BUTTONS);
+
+// A recorded event.
+struct Event {
+  unsigned long time;
+  uint8_t id;
+  uint8_t eventType;
+  uint8_t buttonState;
+};
+
+// The first events are saved, and all the events are folded into a hash.
+static const uint16_t MAX_EVENTS = 8;
+static Event events[MAX_EVENTS];
+static uint16_t numEvents;
+static uint32_t eventsHash;
+
+// FNV-1a hash
+static void addToHash(uint32_t value) {
+  for (uint8_t i = 0; i < 4; i++) {
+    eventsHash = (eventsHash ^ (value & 0xFF)) * 16777619UL;
+    value >>= 8;
+  }
+}
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  unsigned long now = testableConfig.getClock();
+  if (numEvents < MAX_EVENTS) {
+    Event& event = events[numEvents];
+    event.time = now;
+    event.id = button->getId();
+    event.eventType = eventType;
+    event.buttonState = buttonState;
+  }
+  numEvents++;
+  addToHash(now);
+  addToHash(((uint32_t) button->getId() << 16) | (eventType << 8)
+      | buttonState);
+}
+
+// A change of the input of a button in the script.
+struct Change {
+  unsigned long time;
+  uint8_t index;
+  bool pressed;
+};
+
+static const uint16_t NUM_CHANGES = 300;
+static Change script[NUM_CHANGES];
+
+// Generate a reproducible random script of bounces, clicks, double clicks,
+// long presses and long idle periods of more than 65.536 seconds.
+static void generateScript(uint32_t seed) {
+  bool pressed[NUM_BUTTONS] = {false, false};
+  unsigned long time = 100;
+  for (uint16_t i = 0; i < NUM_CHANGES; i++) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t r = seed >> 8;
+    switch (r % 5) {
+      case 0: time += 1 + (r >> 4) % 30; break;
+      case 1: time += 50 + (r >> 4) % 250; break;
+      case 2: time += 300 + (r >> 4) % 1200; break;
+      case 3: time += 1500 + (r >> 4) % 5000; break;
+      default: time += ((r >> 4) % 8 == 0) ? 70000 : 100; break;
+    }
+    uint8_t index = (r >> 12) % NUM_BUTTONS;
+    pressed[index] = !pressed[index];
+    script[i] = {time, index, pressed[index]};
+  }
+}
+
+static uint8_t stateOf(uint8_t index, bool pressed) {
+  uint8_t released = BUTTONS[index]->getDefaultReleasedState();
+  return pressed ? !released : released;
+}
+
+static void initButtons(ButtonConfig::FeatureFlagType features) {
+  testableConfig.init();
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.setFeature(features);
+  button0.init(2, HIGH, 0);
+  button1.init(3, LOW, 1);
+  numEvents = 0;
+  eventsHash = 2166136261UL;
+}
+
+// Run the script by checking every button every millisecond, and return the
+// number of checks.
+static uint32_t runPolling(unsigned long endTime) {
+  uint8_t states[NUM_BUTTONS] = {stateOf(0, false), stateOf(1, false)};
+  uint32_t checks = 0;
+  uint16_t next = 0;
+  for (unsigned long time = 0; time <= endTime; time++) {
+    testableConfig.setClock(time);
+    for (uint8_t i = 0; i < NUM_BUTTONS; i++) {
+      BUTTONS[i]->checkState(states[i]);
+      checks++;
+    }
+    while (next < NUM_CHANGES && script[next].time == time) {
+      const Change& change = script[next++];
+      states[change.index] = stateOf(change.index, change.pressed);
+      BUTTONS[change.index]->checkState(states[change.index]);
+    }
+  }
+  return checks;
+}
+
+// Run the script with the simulator, and return the number of checks.
+static uint32_t runSimulator(unsigned long endTime) {
+  simulator.reset(0);
+  for (uint16_t i = 0; i < NUM_CHANGES; i++) {
+    const Change& change = script[i];
+    if (change.pressed) {
+      simulator.pressButton(change.index, change.time);
+    } else {
+      simulator.releaseButton(change.index, change.time);
+    }
+  }
+  simulator.advanceTo(endTime);
+  return simulator.getNumSteps() * NUM_BUTTONS;
+}
+
+static const ButtonConfig::FeatureFlagType FEATURE_SETS[] = {
+  ButtonConfig::kFeatureClick | ButtonConfig::kFeatureDoubleClick
+      | ButtonConfig::kFeatureLongPress | ButtonConfig::kFeatureRepeatPress,
+  ButtonConfig::kFeatureDoubleClick
+      | ButtonConfig::kFeatureSuppressClickBeforeDoubleClick
+      | ButtonConfig::kFeatureSuppressAfterDoubleClick
+      | ButtonConfig::kFeatureLongPress
+      | ButtonConfig::kFeatureSuppressAfterLongPress,
+  ButtonConfig::kFeatureClick | ButtonConfig::kFeatureRepeatPress
+      | ButtonConfig::kFeatureSuppressAfterRepeatPress
+      | ButtonConfig::kFeatureHeartBeat,
+};
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(ButtonSimulator, same_events_as_polling) {
+  for (uint8_t f = 0; f < sizeof(FEATURE_SETS) / sizeof(FEATURE_SETS[0]);
+      f++) {
+    for (uint32_t seed = 1; seed <= 3; seed++) {
+      generateScript(seed);
+      unsigned long endTime = script[NUM_CHANGES - 1].time + 10000;
+
+      initButtons(FEATURE_SETS[f]);
+      uint32_t pollingChecks = runPolling(endTime);
+      uint16_t numExpected = numEvents;
+      uint32_t expectedHash = eventsHash;
+      assertMore(numExpected, (uint16_t) 100);
+
+      initButtons(FEATURE_SETS[f]);
+      uint32_t simulatorChecks = runSimulator(endTime);
+
+      assertEqual(numExpected, numEvents);
+      assertEqual(expectedHash, eventsHash);
+      assertLess(simulatorChecks * 10, pollingChecks);
+    }
+  }
+}
+
+test(ButtonSimulator, long_press_jumps_to_deadlines) {
+  initButtons(ButtonConfig::kFeatureLongPress
+      | ButtonConfig::kFeatureRepeatPress);
+  simulator.reset(0);
+
+  // Hold the button for 10 minutes: 1 LongPressed, and 1 RepeatPressed every
+  // 200 ms after the first second.
+  simulator.pressButton(0, 100);
+  simulator.releaseButton(0, 600100);
+  simulator.advanceTo(601000);
+
+  // Pressed, LongPressed, RepeatPressed x 2995, Released
+  assertEqual((uint16_t) 2998, numEvents);
+  assertEqual((unsigned long) 120, events[0].time);
+  assertEqual(AceButton::kEventPressed, events[0].eventType);
+  assertEqual((unsigned long) 1120, events[1].time);
+  assertEqual(AceButton::kEventLongPressed, events[1].eventType);
+  assertEqual((unsigned long) 1120, events[2].time);
+  assertEqual(AceButton::kEventRepeatPressed, events[2].eventType);
+  assertEqual((unsigned long) 1320, events[3].time);
+  assertEqual(AceButton::kEventRepeatPressed, events[3].eventType);
+
+  // One step per RepeatPressed, plus a few for the debouncing.
+  assertLess(simulator.getNumSteps(), (uint32_t) 3010);
+  assertEqual((unsigned long) 601000, simulator.getNow());
+}
+
+test(ButtonSimulator, heart_beat) {
+  initButtons(ButtonConfig::kFeatureHeartBeat);
+  simulator.reset(0);
+  simulator.advanceTo(3600000UL);
+
+  // One HeartBeat per button every 5 seconds during one hour.
+  assertEqual((uint16_t) (2 * 720), numEvents);
+  assertEqual((unsigned long) 5000, events[0].time);
+  assertEqual(AceButton::kEventHeartBeat, events[0].eventType);
+  assertLess(simulator.getNumSteps(), (uint32_t) 730);
+}
+
+test(ButtonSimulator, idle_buttons) {
+  initButtons(ButtonConfig::kFeatureClick);
+  simulator.reset(0);
+  simulator.advanceTo(3600000UL);
+
+  // Only the debouncing of the initial state, then one step every 65.535
+  // seconds.
+  assertEqual((uint16_t) 0, numEvents);
+  assertLess(simulator.getNumSteps(), (uint32_t) 60);
+
+  // Advancing to the past does nothing.
+  simulator.advanceTo(1000);
+  assertEqual((unsigned long) 3600000UL, simulator.getNow());
+}
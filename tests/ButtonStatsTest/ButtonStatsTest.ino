@@ -0,0 +1,147 @@
+#line 2 "ButtonStatsTest.ino"
+
+// Verify the instrumentation counters enabled by ACE_BUTTON_STATS=1 (set in
+// the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/TestableEncodedButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+static const uint8_t NUM_PINS = 2;
+static const uint8_t PINS[NUM_PINS] = {2, 3};
+static AceButton b1(nullptr, 1);
+static AceButton b2(nullptr, 2);
+static AceButton b3(nullptr, 3);
+static AceButton* const BUTTONS[] = {&b1, &b2, &b3};
+static TestableEncodedButtonConfig encodedConfig(NUM_PINS, PINS, 3, BUTTONS);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+
+  testableConfig.setEventHandler(handleEvent);
+  encodedConfig.setEventHandler(handleEvent);
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(ButtonStats, button_config_counters) {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.resetStats();
+
+  // Initialization: the change from the unknown state counts as a raw change.
+  helper.checkTime(0);
+  helper.checkTime(50);
+
+  // Press, then bounce back to released before the debouncing ends.
+  helper.pressButton(100);
+  helper.releaseButton(110);
+  helper.checkTime(125);
+
+  // Press, then release, for real.
+  helper.pressButton(200);
+  helper.checkTime(225);
+  helper.releaseButton(300);
+  helper.checkTime(325);
+
+  ButtonStats stats = testableConfig.getStats();
+  assertEqual((uint32_t) 9, stats.checks);
+  assertEqual((uint32_t) 9, stats.reads);
+  assertEqual((uint32_t) 4, stats.rawChanges);
+  assertEqual((uint32_t) 1, stats.bounces);
+  assertEqual((uint32_t) 1, stats.events[AceButton::kEventPressed]);
+  assertEqual((uint32_t) 1, stats.events[AceButton::kEventReleased]);
+  assertEqual((uint32_t) 0, stats.events[AceButton::kEventClicked]);
+
+  testableConfig.resetStats();
+  stats = testableConfig.getStats();
+  assertEqual((uint32_t) 0, stats.checks);
+  assertEqual((uint32_t) 0, stats.reads);
+  assertEqual((uint32_t) 0, stats.rawChanges);
+  assertEqual((uint32_t) 0, stats.bounces);
+  assertEqual((uint32_t) 0, stats.events[AceButton::kEventPressed]);
+}
+
+test(ButtonStats, encoded_button_config_counters) {
+  encodedConfig.init();
+  for (AceButton* b : BUTTONS) b->init(b->getPin());
+  encodedConfig.resetStats();
+
+  // Initialization. The first read of the virtual pin is not a change.
+  encodedConfig.setVirtualPin(0);
+  encodedConfig.setClock(0);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(50);
+  encodedConfig.checkButtons();
+
+  // Press button 1, bounce to button 2, then back to button 1. Each bounce
+  // restarts the debouncing window opened by the first change, so the
+  // virtual pin is accepted at 130.
+  encodedConfig.setVirtualPin(1);
+  encodedConfig.setClock(100);
+  encodedConfig.checkButtons();
+  encodedConfig.setVirtualPin(2);
+  encodedConfig.setClock(105);
+  encodedConfig.checkButtons();
+  encodedConfig.setVirtualPin(1);
+  encodedConfig.setClock(110);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(120);
+  eventTracker.clear();
+  encodedConfig.checkButtons();
+  assertEqual(0, eventTracker.getNumEvents());
+  encodedConfig.setClock(130);
+  encodedConfig.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+
+  // A glitch to no button, which is back to button 1 at the end of the
+  // window, is a bounce.
+  encodedConfig.setVirtualPin(0);
+  encodedConfig.setClock(200);
+  encodedConfig.checkButtons();
+  encodedConfig.setVirtualPin(1);
+  encodedConfig.setClock(205);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(225);
+  eventTracker.clear();
+  encodedConfig.checkButtons();
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // The buttons are not processed until the first virtual pin has settled.
+  ButtonStats stats = encodedConfig.getStats();
+  assertEqual((uint32_t) 10, stats.reads);
+  assertEqual((uint32_t) 27, stats.checks);
+  assertEqual((uint32_t) 2, stats.rawChanges);
+  assertEqual((uint32_t) 1, stats.bounces);
+  assertEqual((uint32_t) 1, stats.events[AceButton::kEventPressed]);
+}
@@ -0,0 +1,247 @@
+#line 2 "ClickTunerTest.ino"
+
+// Verify the ClickTuner enabled by ACE_BUTTON_CLICK_TUNER=1 (set in the
+// Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+// Events accumulated across the calls to the helper, which clears the
+// eventTracker before each check().
+static uint16_t numClicked;
+static uint16_t numDoubleClicked;
+static unsigned long lastClickedTime;
+
+void handleEvent(AceButton* /*button*/, uint8_t eventType,
+    uint8_t /*buttonState*/) {
+  if (eventType == AceButton::kEventClicked) {
+    numClicked++;
+    lastClickedTime = testableConfig.getClock();
+  } else if (eventType == AceButton::kEventDoubleClicked) {
+    numDoubleClicked++;
+  }
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+// TimingHistogram
+// --------------------------------------------------------------------------
+
+test(TimingHistogram, add_and_percentile) {
+  TimingHistogram histogram;
+  histogram.setBucketWidth(25);
+  assertEqual(0, histogram.total());
+  assertEqual(0, histogram.percentile(95));
+
+  for (uint8_t i = 0; i < 19; i++) histogram.add(60);
+  histogram.add(180);
+  // Beyond the last bucket.
+  histogram.add(200);
+  assertEqual(20, histogram.total());
+  assertEqual(19, histogram.getCount(2));
+  assertEqual(1, histogram.getCount(7));
+
+  // 19 of the 20 durations are below 75 ms.
+  assertEqual(75, histogram.percentile(95));
+  assertEqual(200, histogram.percentile(100));
+}
+
+test(TimingHistogram, halves_counts_when_full) {
+  TimingHistogram histogram;
+  histogram.setBucketWidth(10);
+  histogram.add(5);
+  histogram.add(5);
+  for (uint16_t i = 0; i < 255; i++) histogram.add(15);
+  assertEqual(255, histogram.getCount(1));
+  histogram.add(15);
+  assertEqual(1, histogram.getCount(0));
+  assertEqual(128, histogram.getCount(1));
+}
+
+// --------------------------------------------------------------------------
+// ClickTuner
+// --------------------------------------------------------------------------
+
+test(ClickTuner, delays_follow_the_timings) {
+  ClickTuner tuner;
+  assertFalse(tuner.isEnabled());
+  tuner.setBounds(50, 200, 100, 400);
+  assertTrue(tuner.isEnabled());
+
+  // The maximum delays are used until 8 samples are recorded.
+  for (uint8_t i = 0; i < 7; i++) {
+    assertEqual(200, tuner.recordPress(60));
+    assertEqual(400, tuner.recordInterval(120));
+  }
+
+  // Bucket [50, 75) of the presses, plus one bucket.
+  assertEqual(100, tuner.recordPress(60));
+  // Bucket [100, 150) of the intervals, plus one bucket.
+  assertEqual(200, tuner.recordInterval(120));
+
+  // Clamped to the minimums.
+  tuner.setBounds(150, 200, 300, 400);
+  for (uint8_t i = 0; i < 8; i++) {
+    tuner.recordPress(10);
+    tuner.recordInterval(10);
+  }
+  assertEqual(150, tuner.recordPress(10));
+  assertEqual(300, tuner.recordInterval(10));
+}
+
+// --------------------------------------------------------------------------
+// ButtonConfig and AceButton
+// --------------------------------------------------------------------------
+
+static void initButton() {
+  helper.init(PIN, HIGH, BUTTON_ID);
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.disableClickTuner();
+  testableConfig.setClickDelay(ButtonConfig::kClickDelay);
+  testableConfig.setDoubleClickDelay(ButtonConfig::kDoubleClickDelay);
+  testableConfig.setFeature(ButtonConfig::kFeatureDoubleClick);
+  testableConfig.setFeature(
+      ButtonConfig::kFeatureSuppressClickBeforeDoubleClick);
+  numClicked = 0;
+  numDoubleClicked = 0;
+  lastClickedTime = 0;
+  helper.releaseButton(0);
+  helper.releaseButton(50);
+}
+
+// Click the button at 'time'. The press is accepted at time + 25, and the
+// release at time + 85, so the press lasts 60 ms.
+static void click(unsigned long time) {
+  helper.pressButton(time);
+  helper.pressButton(time + 25);
+  helper.releaseButton(time + 60);
+  helper.releaseButton(time + 85);
+}
+
+// Check the button every 5 ms until 'endTime'.
+static void idle(unsigned long time, unsigned long endTime) {
+  for (; time <= endTime; time += 5) helper.checkTime(time);
+}
+
+test(ClickTuner, learns_double_clicks) {
+  initButton();
+  testableConfig.enableClickTuner(50, 100);
+  assertEqual(200, testableConfig.getClickTuner().getMaxClickDelay());
+  assertEqual(400, testableConfig.getClickTuner().getMaxDoubleClickDelay());
+
+  // 8 double-clicks with 120 ms between the releases.
+  unsigned long time = 1000;
+  for (uint8_t i = 0; i < 8; i++) {
+    click(time);
+    click(time + 120);
+    idle(time + 210, time + 995);
+    time += 1000;
+  }
+  assertEqual(8, numDoubleClicked);
+  assertEqual(0, numClicked);
+  assertEqual(100, testableConfig.getClickDelay());
+  assertEqual(200, testableConfig.getDoubleClickDelay());
+
+  // A single click is dispatched 200 ms after its release, instead of 400 ms.
+  click(time);
+  idle(time + 90, time + 400);
+  assertEqual(1, numClicked);
+  assertEqual(time + 85 + 200, lastClickedTime);
+
+  // Double clicks are still detected.
+  time += 1000;
+  click(time);
+  click(time + 120);
+  assertEqual(9, numDoubleClicked);
+}
+
+test(ClickTuner, slow_double_clicks_grow_the_delay) {
+  initButton();
+  testableConfig.enableClickTuner(50, 100);
+
+  unsigned long time = 1000;
+  for (uint8_t i = 0; i < 8; i++) {
+    click(time);
+    click(time + 120);
+    idle(time + 210, time + 995);
+    time += 1000;
+  }
+  assertEqual(200, testableConfig.getDoubleClickDelay());
+
+  // The first clicks 300 ms apart are missed, but they are recorded, until
+  // the double-click delay covers them.
+  for (uint8_t i = 0; i < 12; i++) {
+    click(time);
+    click(time + 300);
+    idle(time + 390, time + 995);
+    time += 1000;
+  }
+  assertEqual(400, testableConfig.getDoubleClickDelay());
+}
+
+test(ClickTuner, ignores_intervals_across_the_rollover) {
+  initButton();
+  testableConfig.enableClickTuner(50, 100);
+
+  // A click released at 1085, then idle past the maximum double-click delay.
+  click(1000);
+  idle(1090, 1600);
+  assertEqual(0, testableConfig.getClickTuner().getIntervals().total());
+
+  // The next click is released 65536 + 120 ms later. Its uint16_t interval
+  // from the previous click rolls over to 120 ms, which must not be
+  // recorded.
+  click(1000 + 65536UL + 120);
+  assertEqual(0, testableConfig.getClickTuner().getIntervals().total());
+
+  // A real double-click is still recorded.
+  click(1000 + 65536UL + 240);
+  assertEqual(1, testableConfig.getClickTuner().getIntervals().total());
+}
+
+test(ClickTuner, disable_restores_the_delays) {
+  initButton();
+  testableConfig.enableClickTuner(50, 100);
+  unsigned long time = 1000;
+  for (uint8_t i = 0; i < 8; i++) {
+    click(time);
+    click(time + 120);
+    idle(time + 210, time + 995);
+    time += 1000;
+  }
+  assertEqual(200, testableConfig.getDoubleClickDelay());
+
+  testableConfig.disableClickTuner();
+  assertFalse(testableConfig.getClickTuner().isEnabled());
+  assertEqual(200, testableConfig.getClickDelay());
+  assertEqual(400, testableConfig.getDoubleClickDelay());
+}
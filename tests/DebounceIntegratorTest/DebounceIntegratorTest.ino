@@ -0,0 +1,128 @@
+#line 2 "DebounceIntegratorTest.ino"
+
+// Verify the integrating debouncer selected by
+// ACE_BUTTON_DEBOUNCE=ACE_BUTTON_DEBOUNCE_INTEGRATOR (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Reset the button and the config, and set the initial released state.
+static void initButton() {
+  helper.init(PIN, HIGH, BUTTON_ID);
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.setDebounceSamples(ButtonConfig::kDebounceSamples);
+
+  // The initial state is accepted after the default 4 samples.
+  for (unsigned long t = 0; t < 4; t++) helper.releaseButton(t);
+}
+
+test(DebounceIntegrator, default_samples) {
+  assertEqual((uint8_t) 4, testableConfig.getDebounceSamples());
+}
+
+test(DebounceIntegrator, press_after_samples) {
+  initButton();
+
+  // The time does not matter, only the number of samples.
+  helper.pressButton(100);
+  helper.pressButton(101);
+  helper.pressButton(102);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(103);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(LOW, eventTracker.getRecord(0).getButtonState());
+}
+
+test(DebounceIntegrator, spikes_do_not_restart) {
+  initButton();
+
+  // Each spike only decrements the counter: 1, 2, 1, 2, 3, 2, 3, 4.
+  helper.pressButton(100);
+  helper.pressButton(101);
+  helper.releaseButton(102);
+  helper.pressButton(103);
+  helper.pressButton(104);
+  helper.releaseButton(105);
+  helper.pressButton(106);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(107);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+}
+
+test(DebounceIntegrator, bounce_back_to_previous_state) {
+  initButton();
+
+  // The counter goes back to 0, and a new change needs 4 samples again.
+  helper.pressButton(100);
+  helper.pressButton(101);
+  assertTrue(button.isDebouncing());
+  helper.releaseButton(102);
+  helper.releaseButton(103);
+  assertFalse(button.isDebouncing());
+  helper.pressButton(104);
+  helper.pressButton(105);
+  helper.pressButton(106);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(107);
+  assertEqual(1, eventTracker.getNumEvents());
+}
+
+test(DebounceIntegrator, click) {
+  initButton();
+  testableConfig.setFeature(ButtonConfig::kFeatureClick);
+  testableConfig.setDebounceSamples(2);
+
+  helper.pressButton(100);
+  helper.pressButton(105);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+
+  helper.releaseButton(150);
+  helper.releaseButton(155);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(1).getEventType());
+}
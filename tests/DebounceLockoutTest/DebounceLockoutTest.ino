@@ -0,0 +1,197 @@
+#line 2 "DebounceLockoutTest.ino"
+
+// Verify the lockout debouncer selected by
+// ACE_BUTTON_DEBOUNCE=ACE_BUTTON_DEBOUNCE_LOCKOUT (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Reset the button and the config, and set the initial released state.
+static void initButton() {
+  helper.init(PIN, HIGH, BUTTON_ID);
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.setDebounceDelay(ButtonConfig::kDebounceDelay);
+  testableConfig.setReleaseDebounceDelay(ButtonConfig::kDebounceDelay);
+
+  // The initial state is accepted immediately, then locked out for 20 ms.
+  helper.releaseButton(0);
+  helper.releaseButton(20);
+}
+
+test(DebounceLockout, first_edge_then_lockout) {
+  initButton();
+
+  // Pressed is dispatched on the first edge.
+  helper.pressButton(100);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(LOW, eventTracker.getRecord(0).getButtonState());
+
+  // The bounces during the lockout are ignored.
+  helper.releaseButton(105);
+  helper.pressButton(110);
+  helper.releaseButton(119);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(120);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Released is dispatched on the first edge after the lockout.
+  helper.releaseButton(200);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(0).getEventType());
+  helper.pressButton(210);
+  assertEqual(0, eventTracker.getNumEvents());
+}
+
+test(DebounceLockout, state_at_end_of_lockout) {
+  initButton();
+
+  // The button was released during the lockout, which is detected at the end
+  // of the lockout.
+  helper.pressButton(100);
+  helper.releaseButton(110);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.releaseButton(120);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(0).getEventType());
+}
+
+test(DebounceLockout, double_click) {
+  initButton();
+  testableConfig.setFeature(ButtonConfig::kFeatureDoubleClick);
+
+  helper.pressButton(100);
+  helper.releaseButton(150);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(1).getEventType());
+
+  helper.pressButton(250);
+  helper.releaseButton(300);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventDoubleClicked,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(1).getEventType());
+}
+
+test(DebounceLockout, separate_press_and_release_delays) {
+  initButton();
+  testableConfig.setDebounceDelay(50);
+  testableConfig.setReleaseDebounceDelay(10);
+
+  // The lockout after the press is 50 ms.
+  helper.pressButton(100);
+  assertEqual(1, eventTracker.getNumEvents());
+  helper.releaseButton(149);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.releaseButton(150);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(0).getEventType());
+
+  // The lockout after the release is 10 ms.
+  helper.pressButton(159);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(160);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+}
+
+test(DebounceLockout, long_press_and_repeat_press) {
+  initButton();
+  testableConfig.setFeature(ButtonConfig::kFeatureLongPress);
+  testableConfig.setFeature(ButtonConfig::kFeatureRepeatPress);
+  testableConfig.setFeature(ButtonConfig::kFeatureSuppressAfterLongPress);
+
+  // The delays are measured from the first edge.
+  helper.pressButton(100);
+  assertEqual(1, eventTracker.getNumEvents());
+  helper.releaseButton(102);
+  helper.pressButton(104);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  helper.pressButton(1099);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(1100);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventLongPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(AceButton::kEventRepeatPressed,
+      eventTracker.getRecord(1).getEventType());
+
+  helper.pressButton(1300);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventRepeatPressed,
+      eventTracker.getRecord(0).getEventType());
+
+  // The Released is replaced by LongReleased immediately.
+  helper.releaseButton(1400);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventLongReleased,
+      eventTracker.getRecord(0).getEventType());
+}
+
+test(DebounceLockout, bouncing_click) {
+  initButton();
+  testableConfig.setFeature(ButtonConfig::kFeatureClick);
+  testableConfig.setFeature(ButtonConfig::kFeatureSuppressAfterClick);
+
+  // A click with bounces on both edges generates a single Pressed and Clicked
+  // on the first edges.
+  helper.pressButton(100);
+  assertEqual(1, eventTracker.getNumEvents());
+  helper.releaseButton(103);
+  helper.pressButton(106);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.releaseButton(150);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+  helper.pressButton(152);
+  helper.releaseButton(155);
+  helper.releaseButton(170);
+  assertEqual(0, eventTracker.getNumEvents());
+}
@@ -0,0 +1,120 @@
+#line 2 "DebounceShiftRegisterTest.ino"
+
+// Verify the shift register debouncer selected by
+// ACE_BUTTON_DEBOUNCE=ACE_BUTTON_DEBOUNCE_SHIFT_REGISTER (set in the
+// Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Reset the button and the config, and set the initial released state.
+static void initButton() {
+  helper.init(PIN, HIGH, BUTTON_ID);
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.setDebounceSamples(ButtonConfig::kDebounceSamples);
+
+  // The initial state is accepted after the default 4 samples.
+  for (unsigned long t = 0; t < 4; t++) helper.releaseButton(t);
+}
+
+test(DebounceShiftRegister, press_after_consecutive_samples) {
+  initButton();
+
+  helper.pressButton(100);
+  helper.pressButton(101);
+  helper.pressButton(102);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(103);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(LOW, eventTracker.getRecord(0).getButtonState());
+
+  // The samples are now relative to the Pressed state.
+  helper.pressButton(104);
+  helper.releaseButton(105);
+  helper.releaseButton(106);
+  helper.releaseButton(107);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.releaseButton(108);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(0).getEventType());
+}
+
+test(DebounceShiftRegister, bounce_needs_new_run) {
+  initButton();
+
+  // A single opposite sample requires 4 new consecutive samples.
+  helper.pressButton(100);
+  helper.pressButton(101);
+  helper.pressButton(102);
+  helper.releaseButton(103);
+  helper.pressButton(104);
+  helper.pressButton(105);
+  helper.pressButton(106);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(107);
+  assertEqual(1, eventTracker.getNumEvents());
+}
+
+test(DebounceShiftRegister, at_most_8_samples) {
+  initButton();
+  testableConfig.setDebounceSamples(20);
+
+  for (unsigned long t = 100; t < 107; t++) helper.pressButton(t);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(107);
+  assertEqual(1, eventTracker.getNumEvents());
+}
+
+test(DebounceShiftRegister, long_press) {
+  initButton();
+  testableConfig.setFeature(ButtonConfig::kFeatureLongPress);
+
+  for (unsigned long t = 100; t < 104; t++) helper.pressButton(t);
+  assertEqual(1, eventTracker.getNumEvents());
+
+  helper.pressButton(1102);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(1103);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventLongPressed,
+      eventTracker.getRecord(0).getEventType());
+}
@@ -48,6 +48,22 @@ static TestableEncodedButtonConfig testableConfig(
 static EventTracker eventTracker;
 static HelperForEncodedButtonConfig helper(&testableConfig, &eventTracker);
 
+// An EncodedButtonConfigN which owns 15 buttons, with a fake clock and virtual
+// pin like TestableEncodedButtonConfig.
+class TestableEncodedButtonConfigN: public EncodedButtonConfigN<NUM_BUTTONS> {
+  public:
+    TestableEncodedButtonConfigN():
+      EncodedButtonConfigN<NUM_BUTTONS>(NUM_PINS, PINS) {}
+
+    unsigned long getClock() override { return mMillis; }
+    PinType getVirtualPin() const override { return mVirtualPin; }
+
+    unsigned long mMillis = 0;
+    PinType mVirtualPin = 0;
+};
+
+static TestableEncodedButtonConfigN testableConfigN;
+
 // Store the arguments passed into the event handler into the EventTracker
 // for assertion later.
 void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
@@ -63,6 +79,7 @@ void setup() {
   while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
 
   testableConfig.setEventHandler(handleEvent);
+  testableConfigN.setEventHandler(handleEvent);
 }
 
 void loop() {
@@ -171,3 +188,199 @@ test(EncodedButtonConfig, click) {
   }
 }
 
+
+test(EncodedButtonConfig, any_pressed_pin_skips_idle_scans) {
+  const unsigned long BASE_TIME = 1000;
+  helper.init();
+  testableConfig.setFeature(ButtonConfig::kFeatureClick);
+  testableConfig.enableAnyPressedPin(true);
+
+  // Initialization phase. The encoder pins are always read until all buttons
+  // have settled into the Released state.
+  helper.releaseButton(BASE_TIME);
+  helper.releaseButton(BASE_TIME + 50);
+  helper.releaseButton(BASE_TIME + 100);
+  uint16_t numReads = testableConfig.getNumVirtualPinReads();
+
+  // Nothing pressed, everything idle, so the encoder pins are not read.
+  helper.releaseButton(BASE_TIME + 150);
+  helper.releaseButton(BASE_TIME + 200);
+  assertEqual(numReads, testableConfig.getNumVirtualPinReads());
+
+  // Click button 3. The "any pressed" pin becomes active.
+  helper.pressButton(BASE_TIME + 300, 3);
+  helper.pressButton(BASE_TIME + 330, 3);
+  assertEqual(1, eventTracker.getNumEvents());
+  helper.releaseButton(BASE_TIME + 400);
+  helper.releaseButton(BASE_TIME + 430);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+
+  // The button is released, but the Clicked event is still pending, waiting
+  // for a possible DoubleClicked, so scanning must continue until the click is
+  // reclaimed as an orphan after getDoubleClickDelay().
+  numReads = testableConfig.getNumVirtualPinReads();
+  helper.releaseButton(BASE_TIME + 500);
+  assertEqual(numReads + 1, testableConfig.getNumVirtualPinReads());
+  helper.releaseButton(BASE_TIME + 900);
+
+  // Idle again.
+  numReads = testableConfig.getNumVirtualPinReads();
+  helper.releaseButton(BASE_TIME + 1000);
+  helper.releaseButton(BASE_TIME + 1100);
+  assertEqual(numReads, testableConfig.getNumVirtualPinReads());
+
+  // The HeartBeat feature requires every button to be checked.
+  testableConfig.setFeature(ButtonConfig::kFeatureHeartBeat);
+  helper.releaseButton(BASE_TIME + 1200);
+  assertEqual(numReads + 1, testableConfig.getNumVirtualPinReads());
+}
+
+// --------------------------------------------------------------------------
+// EncodedButtonConfigN
+// --------------------------------------------------------------------------
+
+test(EncodedButtonConfigN, owned_buttons) {
+  // Buttons are bound to the config, with virtual pin == index + 1 (because 0
+  // means "no button pressed"), and id == index.
+  for (uint8_t i = 0; i < NUM_BUTTONS; i++) {
+    AceButton& button = testableConfigN.getButton(i);
+    assertTrue(button.getButtonConfig() == &testableConfigN);
+    assertEqual(i + 1, button.getPin());
+    assertEqual(i, button.getId());
+  }
+
+  eventTracker.clear();
+  testableConfigN.mMillis = 0;
+  testableConfigN.checkButtons();
+  testableConfigN.mMillis = 50;
+  testableConfigN.checkButtons();
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Press the button at index 4, i.e. virtual pin 5, debounce, then get a
+  // Pressed event from that button only.
+  testableConfigN.mVirtualPin = 5;
+  testableConfigN.mMillis = 100;
+  testableConfigN.checkButtons();
+  testableConfigN.mMillis = 130;
+  testableConfigN.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(5, eventTracker.getRecord(0).getPin());
+  assertEqual(LOW, eventTracker.getRecord(0).getButtonState());
+
+  // Release it, and get a Released event from the same button.
+  eventTracker.clear();
+  testableConfigN.mVirtualPin = 0;
+  testableConfigN.mMillis = 1000;
+  testableConfigN.checkButtons();
+  testableConfigN.mMillis = 1030;
+  testableConfigN.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventReleased,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(5, eventTracker.getRecord(0).getPin());
+  assertEqual(HIGH, eventTracker.getRecord(0).getButtonState());
+}
+
+// --------------------------------------------------------------------------
+// Encoded8To3ButtonConfig
+// --------------------------------------------------------------------------
+
+// The test injects the pin values using EpoxyDuino's digitalReadValue(), so
+// it runs only under EpoxyDuino, not on actual hardware.
+#if defined(EPOXY_DUINO)
+
+static const uint8_t ENCODER_PIN0 = 6;
+static const uint8_t ENCODER_PIN1 = 7;
+static const uint8_t ENCODER_PIN2 = 8;
+static const uint8_t GS_PIN = 9;
+
+// An Encoded8To3ButtonConfig wired to a 74LS148, with a fake clock.
+class TestableEncoded8To3ButtonConfig: public Encoded8To3ButtonConfig {
+  public:
+    TestableEncoded8To3ButtonConfig():
+      Encoded8To3ButtonConfig(ENCODER_PIN0, ENCODER_PIN1, ENCODER_PIN2,
+          HIGH, GS_PIN) {}
+
+    unsigned long getClock() override { return mMillis; }
+
+    void setClock(unsigned long millis) { mMillis = millis; }
+
+  private:
+    unsigned long mMillis = 0;
+};
+
+static TestableEncoded8To3ButtonConfig encoded8To3Config;
+static AceButton e1(&encoded8To3Config, 1);
+static AceButton e2(&encoded8To3Config, 2);
+static AceButton e3(&encoded8To3Config, 3);
+static AceButton* const ENCODED_8TO3_BUTTONS[] = {&e1, &e2, &e3};
+
+// Set the (active LOW) encoder pins to 'code', and the GS pin to 'gs'.
+static void setEncoderPins(uint8_t code, uint8_t gs) {
+  digitalReadValue(ENCODER_PIN0, (code & 0x1) ? LOW : HIGH);
+  digitalReadValue(ENCODER_PIN1, (code & 0x2) ? LOW : HIGH);
+  digitalReadValue(ENCODER_PIN2, (code & 0x4) ? LOW : HIGH);
+  digitalReadValue(GS_PIN, gs);
+}
+
+// Check all the buttons at 'time', collecting their events in eventTracker.
+static void checkEncoded8To3(unsigned long time) {
+  encoded8To3Config.setClock(time);
+  for (AceButton* button : ENCODED_8TO3_BUTTONS) button->check();
+}
+
+test(Encoded8To3ButtonConfig, any_pressed_pin) {
+  encoded8To3Config.setEventHandler(handleEvent);
+  for (AceButton* button : ENCODED_8TO3_BUTTONS) {
+    button->init(&encoded8To3Config, button->getPin());
+  }
+  eventTracker.clear();
+  setEncoderPins(0, HIGH);
+  checkEncoded8To3(0);
+  checkEncoded8To3(50);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // While the GS pin is inactive, the encoder pins are not read, so a glitch
+  // on them is ignored.
+  setEncoderPins(3, HIGH);
+  checkEncoded8To3(100);
+  checkEncoded8To3(150);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Press button 3.
+  setEncoderPins(3, LOW);
+  checkEncoded8To3(200);
+  checkEncoded8To3(230);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(3, eventTracker.getRecord(0).getPin());
+  assertEqual(+AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+
+  // While a button is pressed, only the encoder pins are read, so the GS pin
+  // is ignored.
+  setEncoderPins(3, HIGH);
+  checkEncoded8To3(300);
+  checkEncoded8To3(330);
+  assertEqual(1, eventTracker.getNumEvents());
+
+  // Release button 3.
+  setEncoderPins(0, HIGH);
+  checkEncoded8To3(400);
+  checkEncoded8To3(430);
+  assertEqual(2, eventTracker.getNumEvents());
+  assertEqual(3, eventTracker.getRecord(1).getPin());
+  assertEqual(+AceButton::kEventReleased,
+      eventTracker.getRecord(1).getEventType());
+
+  // No button is pressed, so the GS pin is read again.
+  setEncoderPins(2, HIGH);
+  checkEncoded8To3(500);
+  checkEncoded8To3(550);
+  assertEqual(2, eventTracker.getNumEvents());
+}
+
+#endif
@@ -0,0 +1,189 @@
+#line 2 "EventSinkTest.ino"
+
+// Verify the EventSink, which counts an unlimited number of events and
+// retains the last ones in a ring buffer.
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/ButtonSimulator.h>
+#include <ace_button/testing/EventSink.h>
+#include <ace_button/testing/CapturePrint.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static TestableButtonConfig testableConfig;
+static AceButton button0(&testableConfig, 2, HIGH, 0);
+static AceButton button1(&testableConfig, 3, HIGH, 1);
+static AceButton* const BUTTONS[] = {&button0, &button1};
+static ButtonSimulator simulator(&testableConfig, BUTTONS, 2);
+
+static SinkRecord makeRecord(unsigned long time, PinType pin,
+    uint8_t eventType) {
+  SinkRecord record;
+  record.time = time;
+  record.pin = pin;
+  record.eventType = eventType;
+  record.buttonState = LOW;
+  return record;
+}
+
+// A consumer which counts the events and sums their times.
+struct ConsumerContext {
+  uint32_t count;
+  unsigned long sumTimes;
+};
+
+static void consume(void* context, const SinkRecord& record) {
+  ConsumerContext* consumerContext = (ConsumerContext*) context;
+  consumerContext->count++;
+  consumerContext->sumTimes += record.time;
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(EventSink, ring_buffer_and_counts) {
+  EventSinkN<4, 4> sink;
+  assertEqual((uint16_t) 0, sink.getNumRecords());
+
+  for (uint8_t i = 0; i < 10; i++) {
+    sink.addEvent(makeRecord(100 * i, i % 5, i % 3));
+  }
+  assertEqual((uint32_t) 10, sink.getTotal());
+  assertEqual((uint16_t) 4, sink.getNumRecords());
+  assertEqual((uint32_t) 6, sink.getOverwritten());
+
+  // The oldest retained record is the 7th.
+  for (uint16_t i = 0; i < 4; i++) {
+    assertEqual((unsigned long) (600 + 100 * i), sink.getRecord(i).time);
+  }
+
+  // Event types 0, 1, 2 repeated.
+  assertEqual((uint32_t) 4, sink.getEventCount(0));
+  assertEqual((uint32_t) 3, sink.getEventCount(1));
+  assertEqual((uint32_t) 3, sink.getEventCount(2));
+  assertEqual((uint32_t) 0, sink.getEventCount(200));
+
+  // Pins 0 to 4 repeated, pin 4 is not counted.
+  assertEqual((uint32_t) 2, sink.getPinCount(0));
+  assertEqual((uint32_t) 2, sink.getPinCount(3));
+  assertEqual((uint32_t) 0, sink.getPinCount(4));
+
+  sink.clear();
+  assertEqual((uint32_t) 0, sink.getTotal());
+  assertEqual((uint16_t) 0, sink.getNumRecords());
+  assertEqual((uint32_t) 0, sink.getPinCount(0));
+}
+
+// A ring buffer larger than 32768 records, where the index of the retained
+// records overflows uint16_t after the buffer wraps around.
+static const uint16_t LARGE_CAPACITY = 40000;
+static SinkRecord largeRecords[LARGE_CAPACITY];
+
+test(EventSink, large_ring_buffer) {
+  EventSink sink(largeRecords, LARGE_CAPACITY, nullptr, 0);
+  for (uint32_t i = 0; i < (uint32_t) LARGE_CAPACITY + 30000; i++) {
+    sink.addEvent(makeRecord(i, 0, 0));
+  }
+  assertEqual(LARGE_CAPACITY, sink.getNumRecords());
+  assertEqual((uint32_t) 30000, sink.getOverwritten());
+
+  assertEqual((unsigned long) 30000, sink.getRecord(0).time);
+  assertEqual((unsigned long) 65535, sink.getRecord(35535).time);
+  assertEqual((unsigned long) 69999,
+      sink.getRecord(LARGE_CAPACITY - 1).time);
+}
+
+test(EventSink, consumer_without_ring_buffer) {
+  EventSinkN<0, 0> sink;
+  ConsumerContext context = {0, 0};
+  sink.setConsumer(consume, &context);
+
+  for (uint8_t i = 0; i < 10; i++) {
+    sink.addEvent(makeRecord(i, i, AceButton::kEventClicked));
+  }
+  assertEqual((uint32_t) 10, context.count);
+  assertEqual((unsigned long) 45, context.sumTimes);
+  assertEqual((uint16_t) 0, sink.getNumRecords());
+  assertEqual((uint32_t) 10, sink.getEventCount(AceButton::kEventClicked));
+
+  sink.setConsumer(nullptr, nullptr);
+  sink.addEvent(makeRecord(100, 0, AceButton::kEventClicked));
+  assertEqual((uint32_t) 10, context.count);
+}
+
+test(EventSink, soak_with_simulator) {
+  static EventSinkN<16, 4> sink;
+  testableConfig.init();
+  testableConfig.setIEventHandler(&sink);
+  testableConfig.setFeature(ButtonConfig::kFeatureLongPress);
+  testableConfig.setFeature(ButtonConfig::kFeatureRepeatPress);
+  button0.init(2, HIGH, 0);
+  button1.init(3, HIGH, 1);
+  sink.clear();
+
+  // Hold both buttons for 10 minutes.
+  simulator.reset(0);
+  simulator.pressButton(0, 100);
+  simulator.pressButton(1, 200);
+  simulator.releaseButton(0, 600100);
+  simulator.releaseButton(1, 600200);
+  simulator.advanceTo(601000);
+
+  // Per button: Pressed, LongPressed, RepeatPressed x 2995, Released
+  assertEqual((uint32_t) (2 * 2998), sink.getTotal());
+  assertEqual((uint32_t) (2 * 2995),
+      sink.getEventCount(AceButton::kEventRepeatPressed));
+  assertEqual((uint32_t) 2, sink.getEventCount(AceButton::kEventLongPressed));
+  assertEqual((uint32_t) 2998, sink.getPinCount(2));
+  assertEqual((uint32_t) 2998, sink.getPinCount(3));
+  assertEqual((uint16_t) 16, sink.getNumRecords());
+
+  const SinkRecord& last = sink.getRecord(15);
+  assertEqual((unsigned long) 600220, last.time);
+  assertEqual((PinType) 3, last.pin);
+  assertEqual(AceButton::kEventReleased, last.eventType);
+  assertEqual((uint8_t) HIGH, last.buttonState);
+}
+
+test(EventSink, print_to) {
+  EventSinkN<0, 4> sink;
+  sink.addEvent(makeRecord(0, 1, AceButton::kEventPressed));
+  sink.addEvent(makeRecord(10, 1, AceButton::kEventReleased));
+  sink.addEvent(makeRecord(20, 3, AceButton::kEventPressed));
+
+  CapturePrint capture;
+  sink.printTo(capture);
+  assertEqual(
+      "event,count\n"
+      "Pressed,2\n"
+      "Released,1\n"
+      "Clicked,0\n"
+      "DoubleClicked,0\n"
+      "LongPressed,0\n"
+      "RepeatPressed,0\n"
+      "LongReleased,0\n"
+      "HeartBeat,0\n"
+      "ClickRetracted,0\n"
+      "pin,count\n"
+      "1,2\n"
+      "3,1\n",
+      capture.getCstr());
+}
@@ -0,0 +1,121 @@
+#line 2 "FlightRecorderTest.ino"
+
+// Verify the FlightRecorder, and its connection to ButtonConfig enabled by
+// ACE_BUTTON_FLIGHT_RECORDER=1 (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/FlightRecorder.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/CapturePrint.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+
+  testableConfig.setEventHandler(handleEvent);
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(FlightRecorder, record_size) {
+  assertEqual(4, (int) sizeof(FlightRecord));
+}
+
+test(FlightRecorder, ring_overwrites_oldest) {
+  FlightLog<3> log;
+  log.header.magic = 0;
+  FlightRecorder recorder(log);
+  assertEqual((uint16_t) 0, recorder.getCount());
+  assertEqual((uint16_t) 3, recorder.getCapacity());
+
+  for (uint8_t i = 0; i < 5; i++) {
+    recorder.record(100 * i, i, AceButton::kEventClicked, i & 0x1);
+  }
+
+  assertEqual((uint16_t) 3, recorder.getCount());
+  for (uint8_t i = 0; i < 3; i++) {
+    const FlightRecord& record = recorder.getRecord(i);
+    assertEqual((uint16_t) (100 * (i + 2)), record.time);
+    assertEqual(i + 2, record.id);
+    assertEqual(+AceButton::kEventClicked, record.getEventType());
+    assertEqual((i + 2) & 0x1, record.getButtonState());
+  }
+}
+
+test(FlightRecorder, survives_reset_if_valid) {
+  FlightLog<4> log;
+  log.header.magic = 0;
+  {
+    FlightRecorder recorder(log);
+    recorder.record(10, 1, AceButton::kEventPressed, LOW);
+    recorder.record(20, 1, AceButton::kEventReleased, HIGH);
+  }
+
+  // A new recorder on the same log, as after a reset, keeps the records.
+  {
+    FlightRecorder recorder(log);
+    assertEqual((uint16_t) 2, recorder.getCount());
+    assertEqual((uint16_t) 20, recorder.getRecord(1).time);
+  }
+
+  // A corrupted header clears the log.
+  log.header.next = 4;
+  {
+    FlightRecorder recorder(log);
+    assertEqual((uint16_t) 0, recorder.getCount());
+  }
+}
+
+test(FlightRecorder, records_events_of_button_config) {
+  FlightLog<8> log;
+  log.header.magic = 0;
+  FlightRecorder recorder(log);
+  testableConfig.setFlightRecorder(&recorder);
+
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  helper.checkTime(0);
+  helper.checkTime(50);
+  helper.pressButton(100);
+  helper.checkTime(130);
+  helper.releaseButton(200);
+  helper.checkTime(230);
+  testableConfig.setFlightRecorder(nullptr);
+
+  CapturePrint capture;
+  recorder.printTo(capture);
+  assertEqual(
+      "time,id,event,state\n"
+      "130,1,Pressed,0\n"
+      "230,1,Released,1\n",
+      capture.getCstr());
+}
@@ -0,0 +1,133 @@
+#line 2 "HandlerWatchdogTest.ino"
+
+// Verify the execution time watchdog of the event handler enabled by
+// ACE_BUTTON_HANDLER_WATCHDOG=1 (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+// Simulated execution time of the event handler for each event type.
+static unsigned long handlerMicros[8];
+
+// Arguments of the last call to the BudgetExceededHandler.
+static uint8_t numExceeded;
+static AceButton* exceededButton;
+static uint8_t exceededEventType;
+static uint32_t exceededMicros;
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+  testableConfig.setClockMicros(
+      testableConfig.getClockMicros() + handlerMicros[eventType]);
+}
+
+void handleBudgetExceeded(AceButton* button, uint8_t eventType,
+    uint32_t elapsedMicros) {
+  numExceeded++;
+  exceededButton = button;
+  exceededEventType = eventType;
+  exceededMicros = elapsedMicros;
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+
+  testableConfig.setEventHandler(handleEvent);
+  testableConfig.setBudgetExceededHandler(handleBudgetExceeded);
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Initialize the button, then press and release it, which dispatches the
+// Pressed, Clicked and Released events.
+static void click() {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.setFeature(ButtonConfig::kFeatureClick);
+  testableConfig.resetHandlerStats();
+  numExceeded = 0;
+
+  helper.checkTime(0);
+  helper.checkTime(50);
+  helper.pressButton(100);
+  helper.checkTime(130);
+  helper.releaseButton(200);
+  helper.checkTime(230);
+}
+
+test(HandlerWatchdog, no_budget) {
+  handlerMicros[AceButton::kEventPressed] = 10;
+  handlerMicros[AceButton::kEventClicked] = 300;
+  handlerMicros[AceButton::kEventReleased] = 20;
+  testableConfig.setHandlerBudget(0);
+  click();
+
+  const HandlerStats& stats = testableConfig.getHandlerStats();
+  assertEqual((uint32_t) 3, stats.count);
+  assertEqual((uint32_t) 0, stats.overBudget);
+  assertEqual((uint32_t) 300, stats.maxMicros);
+  assertEqual((uint16_t) BUTTON_ID, stats.worstId);
+  assertEqual(+AceButton::kEventClicked, stats.worstEventType);
+  assertEqual(0, numExceeded);
+}
+
+test(HandlerWatchdog, over_budget) {
+  handlerMicros[AceButton::kEventPressed] = 150;
+  handlerMicros[AceButton::kEventClicked] = 300;
+  handlerMicros[AceButton::kEventReleased] = 100;
+  testableConfig.setHandlerBudget(100);
+  click();
+
+  // A call which takes exactly the budget is not over the budget.
+  const HandlerStats& stats = testableConfig.getHandlerStats();
+  assertEqual((uint32_t) 3, stats.count);
+  assertEqual((uint32_t) 2, stats.overBudget);
+  assertEqual((uint32_t) 300, stats.maxMicros);
+  assertEqual(+AceButton::kEventClicked, stats.worstEventType);
+
+  assertEqual(2, numExceeded);
+  assertTrue(exceededButton == &button);
+  assertEqual(+AceButton::kEventClicked, exceededEventType);
+  assertEqual((uint32_t) 300, exceededMicros);
+
+  testableConfig.resetHandlerStats();
+  assertEqual((uint32_t) 0, stats.count);
+  assertEqual((uint32_t) 0, stats.maxMicros);
+}
+
+test(HandlerWatchdog, no_event_handler) {
+  testableConfig.setEventHandler(nullptr);
+  click();
+
+  // The dispatches without an event handler are not measured.
+  const HandlerStats& stats = testableConfig.getHandlerStats();
+  assertEqual((uint32_t) 0, stats.count);
+  assertEqual((uint32_t) 0, stats.maxMicros);
+  testableConfig.setEventHandler(handleEvent);
+}
@@ -0,0 +1,132 @@
+#line 2 "InputTraceTest.ino"
+
+// Verify the InputTraceWriter and InputTraceReader.
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/InputTrace.h>
+
+using namespace aunit;
+using namespace ace_button;
+
+// --------------------------------------------------------------------------
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(InputTrace, varint) {
+  uint8_t buffer[InputTrace::kMaxVarintSize];
+  uint32_t value;
+
+  assertEqual(1, InputTrace::encodeVarint(buffer, 0));
+  assertEqual(1, InputTrace::encodeVarint(buffer, 127));
+  assertEqual(2, InputTrace::encodeVarint(buffer, 128));
+  assertEqual(0x80, buffer[0]);
+  assertEqual(0x01, buffer[1]);
+  assertEqual(2, InputTrace::decodeVarint(buffer, 2, value));
+  assertEqual((uint32_t) 128, value);
+
+  assertEqual(5, InputTrace::encodeVarint(buffer, 0xFFFFFFFF));
+  assertEqual(5, InputTrace::decodeVarint(buffer, 5, value));
+  assertEqual((uint32_t) 0xFFFFFFFF, value);
+
+  // Truncated varint.
+  assertEqual(0, InputTrace::decodeVarint(buffer, 4, value));
+}
+
+test(InputTrace, write_and_read) {
+  uint8_t buffer[64];
+  InputTraceWriter writer(buffer, sizeof(buffer));
+  assertEqual((size_t) InputTrace::kHeaderSize, writer.getSize());
+
+  assertTrue(writer.record(1000, 2, LOW));
+  assertTrue(writer.record(1005, 2, HIGH));
+  assertTrue(writer.record(1300, 200, LOW));
+  assertEqual((uint32_t) 3, writer.getNumRecords());
+
+  // 1000 ms needs 2 bytes, 5 ms needs 1 byte, 295 ms needs 2 bytes. The pin
+  // and level of pin 2 need 1 byte, and of pin 200 need 2 bytes.
+  assertEqual((size_t) (InputTrace::kHeaderSize + 3 + 2 + 4),
+      writer.getSize());
+
+  InputTraceReader reader(writer.getBuffer(), writer.getSize());
+  assertTrue(reader.isValid());
+  InputEvent event;
+  assertTrue(reader.next(event));
+  assertEqual((uint32_t) 1000, event.time);
+  assertEqual(2, event.pin);
+  assertEqual(LOW, event.level);
+  assertTrue(reader.next(event));
+  assertEqual((uint32_t) 1005, event.time);
+  assertEqual(HIGH, event.level);
+  assertTrue(reader.next(event));
+  assertEqual((uint32_t) 1300, event.time);
+  assertEqual(200, event.pin);
+  assertEqual(LOW, event.level);
+  assertFalse(reader.next(event));
+  assertTrue(reader.isEnd());
+
+  reader.rewind();
+  assertTrue(reader.next(event));
+  assertEqual((uint32_t) 1000, event.time);
+}
+
+test(InputTrace, full_buffer) {
+  uint8_t buffer[InputTrace::kHeaderSize + 3];
+  InputTraceWriter writer(buffer, sizeof(buffer));
+  assertTrue(writer.record(10, 1, HIGH));
+  assertFalse(writer.record(20, 1, LOW));
+  assertEqual((uint32_t) 1, writer.getNumRecords());
+  assertEqual((size_t) (InputTrace::kHeaderSize + 2), writer.getSize());
+
+  writer.clear();
+  assertEqual((uint32_t) 0, writer.getNumRecords());
+  assertTrue(writer.record(20, 1, LOW));
+}
+
+test(InputTrace, invalid_or_truncated) {
+  uint8_t buffer[32];
+  InputTraceWriter writer(buffer, sizeof(buffer));
+  writer.record(1000, 1, HIGH);
+  InputEvent event;
+
+  // Truncated in the middle of the time of the record.
+  InputTraceReader truncated(buffer, InputTrace::kHeaderSize + 1);
+  assertTrue(truncated.isValid());
+  assertFalse(truncated.next(event));
+
+  buffer[3] = InputTrace::kVersion + 1;
+  InputTraceReader invalid(buffer, writer.getSize());
+  assertFalse(invalid.isValid());
+  assertFalse(invalid.next(event));
+}
+
+#if ! ACE_BUTTON_WIDE_PINS
+test(InputTrace, pin_too_large) {
+  // A record of pin 300, written by a device with ACE_BUTTON_WIDE_PINS.
+  uint8_t buffer[InputTrace::kHeaderSize + 3];
+  InputTrace::writeHeader(buffer);
+  buffer[InputTrace::kHeaderSize] = 10;
+  InputTrace::encodeVarint(
+      buffer + InputTrace::kHeaderSize + 1, (300 << 1) | HIGH);
+
+  // It is rejected, instead of being read as pin 44.
+  InputTraceReader reader(buffer, sizeof(buffer));
+  assertTrue(reader.isValid());
+  InputEvent event;
+  assertFalse(reader.next(event));
+  assertFalse(reader.isEnd());
+}
+#endif
@@ -45,6 +45,22 @@ static TestableLadderButtonConfig testableConfig(
 static EventTracker eventTracker;
 static HelperForLadderButtonConfig helper(&testableConfig, &eventTracker);
 
+// A LadderButtonConfigN which owns 4 buttons, with the same fake clock and
+// virtual pin as TestableLadderButtonConfig.
+class TestableLadderButtonConfigN: public LadderButtonConfigN<NUM_BUTTONS> {
+  public:
+    TestableLadderButtonConfigN():
+      LadderButtonConfigN<NUM_BUTTONS>(BUTTON_PIN, NUM_LEVELS, LEVELS) {}
+
+    unsigned long getClock() override { return mMillis; }
+    PinType getVirtualPin() const override { return mVirtualPin; }
+
+    unsigned long mMillis = 0;
+    PinType mVirtualPin = NUM_LEVELS - 1;
+};
+
+static TestableLadderButtonConfigN testableConfigN;
+
 // Store the arguments passed into the event handler into the EventTracker
 // for assertion later.
 void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
@@ -60,6 +76,7 @@ void setup() {
   while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
 
   testableConfig.setEventHandler(handleEvent);
+  testableConfigN.setEventHandler(handleEvent);
 }
 
 void loop() {
@@ -181,3 +198,109 @@ test(LadderButtonConfig, click) {
   }
 }
 
+
+test(LadderButtonConfig, bounce_between_adjacent_levels) {
+  const unsigned long BASE_TIME = 65500; // rolls over in 36 milliseconds
+  helper.init();
+
+  // Start the AceButton.check().
+  helper.releaseButton(BASE_TIME);
+
+  // Initialization phase.
+  helper.releaseButton(BASE_TIME + 50);
+
+  // Press button 1, which bounces into the adjacent level of button 2, then
+  // back to button 1. The first change opens the shared debouncing window,
+  // and each bounce restarts it.
+  helper.pressButton(BASE_TIME + 100, 1);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(BASE_TIME + 115, 2);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(BASE_TIME + 125, 1);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // The virtual pin is accepted after 20 ms without a change, and only button
+  // 1 is Pressed. Button 2 never sees the bounce.
+  helper.pressButton(BASE_TIME + 145, 1);
+  assertEqual(1, eventTracker.getNumEvents());
+  {
+    const EventRecord& record = eventTracker.getRecord(0);
+    assertEqual(AceButton::kEventPressed, record.getEventType());
+    assertEqual(1, record.getPin());
+    assertEqual(LOW, record.getButtonState());
+  }
+
+  // Release the button, after 20 ms, register a Released.
+  helper.releaseButton(BASE_TIME + 1000);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.releaseButton(BASE_TIME + 1030);
+  assertEqual(1, eventTracker.getNumEvents());
+  {
+    const EventRecord& record = eventTracker.getRecord(0);
+    assertEqual(AceButton::kEventReleased, record.getEventType());
+    assertEqual(1, record.getPin());
+  }
+}
+
+// A ladder sitting on the boundary between 2 levels chatters without ever
+// settling. Neither level is accepted until the virtual pin is stable for the
+// debouncing delay, so neither button is pressed during the chatter.
+test(LadderButtonConfig, continuous_chatter) {
+  const unsigned long BASE_TIME = 65500; // rolls over in 36 milliseconds
+  helper.init();
+  helper.releaseButton(BASE_TIME);
+  helper.releaseButton(BASE_TIME + 50);
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Alternate between buttons 1 and 2 every 8 ms for 2 seconds, which is
+  // shorter than the 20 ms debouncing delay.
+  uint16_t numEvents = 0;
+  PinType virtualPin = 1;
+  for (unsigned long t = 100; t < 2100; t += 8) {
+    helper.pressButton(BASE_TIME + t, virtualPin);
+    numEvents += eventTracker.getNumEvents();
+    virtualPin = (virtualPin == 1) ? 2 : 1;
+  }
+  assertEqual(0, numEvents);
+
+  // The chatter stops on button 1, which is Pressed 20 ms later.
+  helper.pressButton(BASE_TIME + 2100, 1);
+  assertEqual(0, eventTracker.getNumEvents());
+  helper.pressButton(BASE_TIME + 2120, 1);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(1, eventTracker.getRecord(0).getPin());
+}
+
+// --------------------------------------------------------------------------
+// LadderButtonConfigN
+// --------------------------------------------------------------------------
+
+test(LadderButtonConfigN, owned_buttons) {
+  // Buttons are bound to the config, with virtual pin and id == index.
+  for (uint8_t i = 0; i < NUM_BUTTONS; i++) {
+    AceButton& button = testableConfigN.getButton(i);
+    assertTrue(button.getButtonConfig() == &testableConfigN);
+    assertEqual(i, button.getPin());
+    assertEqual(i, button.getId());
+  }
+
+  eventTracker.clear();
+  testableConfigN.mMillis = 0;
+  testableConfigN.checkButtons();
+  testableConfigN.mMillis = 50;
+  testableConfigN.checkButtons();
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Press button 2, debounce, then get a Pressed event.
+  testableConfigN.mVirtualPin = 2;
+  testableConfigN.mMillis = 100;
+  testableConfigN.checkButtons();
+  testableConfigN.mMillis = 130;
+  testableConfigN.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual(2, eventTracker.getRecord(0).getPin());
+}
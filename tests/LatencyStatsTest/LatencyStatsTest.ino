@@ -0,0 +1,221 @@
+#line 2 "LatencyStatsTest.ino"
+
+// Verify the edge-to-dispatch latency histograms enabled by
+// ACE_BUTTON_LATENCY=1 (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/TestableEncodedButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/CapturePrint.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+static const uint8_t NUM_PINS = 2;
+static const uint8_t PINS[NUM_PINS] = {2, 3};
+static AceButton b1(nullptr, 1);
+static AceButton b2(nullptr, 2);
+static AceButton b3(nullptr, 3);
+static AceButton* const BUTTONS[] = {&b1, &b2, &b3};
+static TestableEncodedButtonConfig encodedConfig(NUM_PINS, PINS, 3, BUTTONS);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+
+  testableConfig.setEventHandler(handleEvent);
+  encodedConfig.setEventHandler(handleEvent);
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(LatencyHistogram, buckets) {
+  assertEqual(0, LatencyHistogram::bucketOf(0));
+  assertEqual(1, LatencyHistogram::bucketOf(1));
+  assertEqual(2, LatencyHistogram::bucketOf(2));
+  assertEqual(2, LatencyHistogram::bucketOf(3));
+  assertEqual(3, LatencyHistogram::bucketOf(4));
+  assertEqual(5, LatencyHistogram::bucketOf(31));
+  assertEqual(6, LatencyHistogram::bucketOf(32));
+  assertEqual(16, LatencyHistogram::bucketOf(65535));
+
+  assertEqual((uint16_t) 0, LatencyHistogram::bucketMin(0));
+  assertEqual((uint16_t) 0, LatencyHistogram::bucketMax(0));
+  assertEqual((uint16_t) 16, LatencyHistogram::bucketMin(5));
+  assertEqual((uint16_t) 31, LatencyHistogram::bucketMax(5));
+  assertEqual((uint16_t) 32768, LatencyHistogram::bucketMin(16));
+  assertEqual((uint16_t) 65535, LatencyHistogram::bucketMax(16));
+}
+
+test(LatencyHistogram, saturates) {
+  LatencyHistogram histogram = LatencyHistogram();
+  histogram.counts[3] = 0xFFFE;
+  histogram.add(4);
+  histogram.add(5);
+  assertEqual((uint16_t) 0xFFFF, histogram.counts[3]);
+  assertEqual((uint32_t) 0xFFFF, histogram.total());
+}
+
+test(LatencyStats, button_config_latencies) {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.setFeature(ButtonConfig::kFeatureClick);
+  testableConfig.resetLatencyStats();
+
+  helper.checkTime(0);
+  helper.checkTime(50);
+
+  // Pressed is dispatched 30 ms after the raw edge, because check() is called
+  // 10 ms after the end of the debouncing.
+  helper.pressButton(100);
+  helper.checkTime(130);
+  assertEqual(1, eventTracker.getNumEvents());
+
+  // Clicked and Released are dispatched 25 ms after the raw edge.
+  helper.releaseButton(200);
+  helper.checkTime(225);
+  assertEqual(2, eventTracker.getNumEvents());
+
+  const LatencyStats& stats = testableConfig.getLatencyStats();
+  const LatencyHistogram& pressed =
+      stats.histograms[AceButton::kEventPressed];
+  assertEqual((uint32_t) 1, pressed.total());
+  assertEqual((uint16_t) 1, pressed.counts[LatencyHistogram::bucketOf(30)]);
+  const LatencyHistogram& released =
+      stats.histograms[AceButton::kEventReleased];
+  assertEqual((uint16_t) 1, released.counts[LatencyHistogram::bucketOf(25)]);
+  const LatencyHistogram& clicked =
+      stats.histograms[AceButton::kEventClicked];
+  assertEqual((uint16_t) 1, clicked.counts[LatencyHistogram::bucketOf(25)]);
+
+  CapturePrint capture;
+  stats.printTo(capture);
+  assertEqual(
+      "event,min,max,count\n"
+      "Pressed,16,31,1\n"
+      "Released,16,31,1\n"
+      "Clicked,16,31,1\n",
+      capture.getCstr());
+
+  testableConfig.resetLatencyStats();
+  assertEqual((uint32_t) 0, pressed.total());
+  assertEqual((uint32_t) 0, released.total());
+}
+
+test(LatencyStats, postponed_click_includes_double_click_delay) {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.setFeature(ButtonConfig::kFeatureDoubleClick);
+  testableConfig.setFeature(
+      ButtonConfig::kFeatureSuppressClickBeforeDoubleClick);
+  testableConfig.resetLatencyStats();
+
+  helper.checkTime(0);
+  helper.checkTime(50);
+  helper.pressButton(100);
+  helper.checkTime(120);
+  helper.releaseButton(200);
+  helper.checkTime(220);
+
+  // The Clicked event is postponed until the double-click delay expires.
+  helper.checkTime(1000);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventClicked,
+      eventTracker.getRecord(0).getEventType());
+
+  const LatencyStats& stats = testableConfig.getLatencyStats();
+  const LatencyHistogram& clicked =
+      stats.histograms[AceButton::kEventClicked];
+  assertEqual((uint16_t) 1, clicked.counts[LatencyHistogram::bucketOf(800)]);
+}
+
+test(LatencyStats, long_press_is_measured_from_the_press) {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.setFeature(ButtonConfig::kFeatureLongPress);
+  testableConfig.resetLatencyStats();
+
+  helper.checkTime(0);
+  helper.checkTime(50);
+  helper.pressButton(100);
+  helper.pressButton(120);
+
+  // A glitch during the press opens a debouncing window at 900 ms, which
+  // ends on the pressed state.
+  helper.releaseButton(900);
+  helper.pressButton(905);
+  helper.pressButton(920);
+
+  // LongPressed is dispatched 1000 ms after the Pressed event, i.e. 1020 ms
+  // after the raw edge of the press, not 220 ms after the glitch.
+  helper.pressButton(1120);
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(+AceButton::kEventLongPressed,
+      eventTracker.getRecord(0).getEventType());
+
+  const LatencyStats& stats = testableConfig.getLatencyStats();
+  const LatencyHistogram& longPressed =
+      stats.histograms[AceButton::kEventLongPressed];
+  assertEqual((uint32_t) 1, longPressed.total());
+  assertEqual((uint16_t) 1,
+      longPressed.counts[LatencyHistogram::bucketOf(1020)]);
+}
+
+test(LatencyStats, encoded_button_config_measures_from_first_change) {
+  encodedConfig.init();
+  for (AceButton* b : BUTTONS) b->init(b->getPin());
+  encodedConfig.resetLatencyStats();
+
+  encodedConfig.setVirtualPin(0);
+  encodedConfig.setClock(0);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(50);
+  encodedConfig.checkButtons();
+
+  // Press button 1 at 100 ms, bounce to button 2, then back to button 1.
+  // The virtual pin settles at 130 ms, 30 ms after the first change.
+  encodedConfig.setVirtualPin(1);
+  encodedConfig.setClock(100);
+  encodedConfig.checkButtons();
+  encodedConfig.setVirtualPin(2);
+  encodedConfig.setClock(105);
+  encodedConfig.checkButtons();
+  encodedConfig.setVirtualPin(1);
+  encodedConfig.setClock(110);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(130);
+  eventTracker.clear();
+  encodedConfig.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+
+  const LatencyHistogram& pressed =
+      encodedConfig.getLatencyStats().histograms[AceButton::kEventPressed];
+  assertEqual((uint32_t) 1, pressed.total());
+  assertEqual((uint16_t) 1, pressed.counts[LatencyHistogram::bucketOf(30)]);
+}
@@ -0,0 +1,153 @@
+#line 2 "OversampledButtonConfigTest.ino"
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/OversampledButtonConfig.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+/**
+ * A TestableButtonConfig which inverts the next few reads of the button, to
+ * simulate an EMI spike which is shorter than a call to AceButton::check().
+ */
+class SpikyButtonConfig : public TestableButtonConfig {
+  public:
+    int readButton(PinType pin) override {
+      int state = TestableButtonConfig::readButton(pin);
+      if (mSpikeReads == 0) return state;
+      mSpikeReads--;
+      return (state == HIGH) ? LOW : HIGH;
+    }
+
+    /** Invert the next 'numReads' reads. */
+    void spikeNextReads(uint8_t numReads) { mSpikeReads = numReads; }
+
+  private:
+    uint8_t mSpikeReads = 0;
+};
+
+/** Return the bitmaps of an array, one per call. */
+class ArrayReader {
+  public:
+    ArrayReader(const uint8_t* samples) : mSamples(samples) {}
+
+    uint8_t operator()() { return mSamples[mIndex++]; }
+
+  private:
+    const uint8_t* mSamples;
+    uint8_t mIndex = 0;
+};
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static SpikyButtonConfig spikyConfig;
+static OversampledButtonConfig<3, SpikyButtonConfig> oversampledConfig;
+static AceButton button;
+static EventTracker eventTracker;
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+// majorityVote()
+// --------------------------------------------------------------------------
+
+test(majorityVote, single_pin) {
+  static const uint8_t SAMPLES[] = {1, 0, 1, 0, 0};
+  assertEqual(1, (internal::majorityVote<3, uint8_t>(ArrayReader(SAMPLES))));
+  assertEqual(0, (internal::majorityVote<5, uint8_t>(ArrayReader(SAMPLES))));
+  assertEqual(1, (internal::majorityVote<1, uint8_t>(ArrayReader(SAMPLES))));
+}
+
+test(majorityVote, each_bit_is_voted_separately) {
+  static const uint8_t SAMPLES[] = {0x0F, 0x33, 0x55};
+  // Bits set in at least 2 of the 3 samples.
+  assertEqual(0x17, (internal::majorityVote<3, uint8_t>(ArrayReader(SAMPLES))));
+}
+
+test(majorityVote, quorum_of_larger_votes) {
+  static const uint8_t SAMPLES[] = {
+    0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF, 0x00,
+  };
+  // Bit 'i' is set in (8 - i) samples, and the quorum is 5 of 9.
+  assertEqual(0x0F, (internal::majorityVote<9, uint8_t>(ArrayReader(SAMPLES))));
+  // Quorum of 4 in the first 7 samples, where bit 'i' is set in (7 - i).
+  assertEqual(0x0F, (internal::majorityVote<7, uint8_t>(ArrayReader(SAMPLES))));
+}
+
+// --------------------------------------------------------------------------
+// OversampledButtonConfig
+// --------------------------------------------------------------------------
+
+test(OversampledButtonConfig, readButton_votes_out_short_spikes) {
+  oversampledConfig.init();
+  oversampledConfig.setButtonState(HIGH);
+  assertEqual(HIGH, oversampledConfig.readButton(PIN));
+
+  // A spike on 1 of the 3 samples is voted out.
+  oversampledConfig.spikeNextReads(1);
+  assertEqual(HIGH, oversampledConfig.readButton(PIN));
+
+  // A spike on 2 of the 3 samples wins the vote.
+  oversampledConfig.spikeNextReads(2);
+  assertEqual(LOW, oversampledConfig.readButton(PIN));
+
+  oversampledConfig.setButtonState(LOW);
+  assertEqual(LOW, oversampledConfig.readButton(PIN));
+}
+
+// Press at 100, and inject a short spike at 120, at the end of the debouncing
+// delay. Return the time of the kEventPressed.
+static unsigned long pressWithSpike(TestableButtonConfig* config,
+    SpikyButtonConfig* spiky) {
+  HelperForButtonConfig helper(config, &button, &eventTracker);
+  button.setButtonConfig(config);
+  helper.init(PIN, HIGH, BUTTON_ID);
+  config->setEventHandler(handleEvent);
+  config->setDebounceDelay(ButtonConfig::kDebounceDelay);
+  helper.releaseButton(0);
+  helper.releaseButton(50);
+
+  for (unsigned long now = 100; now < 200; now += 5) {
+    if (now == 120) spiky->spikeNextReads(1);
+    helper.pressButton(now);
+    if (eventTracker.getNumEvents() > 0) {
+      if (eventTracker.getRecord(0).getEventType()
+          == AceButton::kEventPressed) {
+        return now;
+      }
+    }
+  }
+  return 0;
+}
+
+test(OversampledButtonConfig, spike_does_not_restart_debouncing) {
+  // A single read sees the spike, which cancels the press and restarts the
+  // debouncing at the next check().
+  assertEqual(145UL, pressWithSpike(&spikyConfig, &spikyConfig));
+
+  // The majority vote hides the spike from the debouncing.
+  assertEqual(120UL, pressWithSpike(&oversampledConfig, &oversampledConfig));
+}
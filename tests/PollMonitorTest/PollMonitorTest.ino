@@ -0,0 +1,95 @@
+#line 2 "PollMonitorTest.ino"
+
+// Verify the monitor of the intervals between checks enabled by
+// ACE_BUTTON_POLL_MONITOR=1 (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/TestableEncodedButtonConfig.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static TestableButtonConfig testableConfig;
+static AceButton button1(&testableConfig, 1);
+static AceButton button2(&testableConfig, 2);
+
+static const uint8_t NUM_PINS = 2;
+static const uint8_t PINS[NUM_PINS] = {2, 3};
+static AceButton b1(nullptr, 1);
+static AceButton b2(nullptr, 2);
+static AceButton b3(nullptr, 3);
+static AceButton* const BUTTONS[] = {&b1, &b2, &b3};
+static TestableEncodedButtonConfig encodedConfig(NUM_PINS, PINS, 3, BUTTONS);
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Check both buttons at the given time, like a loop() would.
+static void checkButtonsAt(unsigned long time) {
+  testableConfig.setClock(time);
+  button1.check();
+  button2.check();
+}
+
+test(PollMonitor, button_config_intervals) {
+  testableConfig.init();
+  testableConfig.resetPollStats();
+
+  // The intervals are 5, 10, 45 and 340 ms. The second button of each scan is
+  // not measured.
+  checkButtonsAt(0);
+  checkButtonsAt(5);
+  checkButtonsAt(15);
+  checkButtonsAt(60);
+  checkButtonsAt(400);
+
+  const PollStats& stats = testableConfig.getPollStats();
+  assertEqual((uint32_t) 4, stats.count);
+  assertEqual((uint16_t) 5, stats.minInterval);
+  assertEqual((uint16_t) 340, stats.maxInterval);
+  assertEqual((uint16_t) 100, stats.getAvgInterval());
+  assertEqual((uint32_t) 2, stats.overDebounceDelay);
+  assertEqual((uint32_t) 1, stats.overClickDelay);
+
+  testableConfig.resetPollStats();
+  assertEqual((uint32_t) 0, stats.count);
+  assertEqual((uint16_t) 0, stats.getAvgInterval());
+}
+
+test(PollMonitor, encoded_button_config_intervals) {
+  encodedConfig.init();
+  for (AceButton* b : BUTTONS) b->init(b->getPin());
+  encodedConfig.resetPollStats();
+
+  encodedConfig.setVirtualPin(0);
+  encodedConfig.setClock(0);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(10);
+  encodedConfig.checkButtons();
+  encodedConfig.setClock(40);
+  encodedConfig.checkButtons();
+
+  const PollStats& stats = encodedConfig.getPollStats();
+  assertEqual((uint32_t) 2, stats.count);
+  assertEqual((uint16_t) 10, stats.minInterval);
+  assertEqual((uint16_t) 30, stats.maxInterval);
+  assertEqual((uint32_t) 1, stats.overDebounceDelay);
+  assertEqual((uint32_t) 0, stats.overClickDelay);
+}
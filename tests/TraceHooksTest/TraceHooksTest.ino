@@ -0,0 +1,166 @@
+#line 2 "TraceHooksTest.ino"
+
+// Verify the trace points of the state machine of AceButton enabled by
+// ACE_BUTTON_TRACE=1 (set in the Makefile).
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/TraceHooks.h>
+#include <ace_button/testing/TestableButtonConfig.h>
+#include <ace_button/testing/HelperForButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+struct TraceRecord {
+  const AceButton* button;
+  uint8_t tracePoint;
+  uint16_t now;
+  uint8_t detail;
+};
+
+static const uint8_t MAX_TRACES = 16;
+static TraceRecord traces[MAX_TRACES];
+static uint8_t numTraces;
+
+namespace ace_button {
+
+void traceHook(const AceButton* button, uint8_t tracePoint, uint16_t now,
+    uint8_t detail) {
+  if (numTraces >= MAX_TRACES) return;
+  traces[numTraces++] = {button, tracePoint, now, detail};
+}
+
+}
+
+static const PinType PIN = 13;
+static const IdType BUTTON_ID = 1;
+
+static TestableButtonConfig testableConfig;
+static AceButton button(&testableConfig);
+static EventTracker eventTracker;
+static HelperForButtonConfig helper(&testableConfig, &button, &eventTracker);
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+
+  testableConfig.setEventHandler(handleEvent);
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+// Initialize the button with the given features, and clear the traces of the
+// initialization.
+static void initButton(ButtonConfig::FeatureFlagType features) {
+  const uint8_t DEFAULT_RELEASED_STATE = HIGH;
+  helper.init(PIN, DEFAULT_RELEASED_STATE, BUTTON_ID);
+  testableConfig.setFeature(features);
+  helper.checkTime(0);
+  helper.checkTime(50);
+  numTraces = 0;
+}
+
+// Return true if the i-th trace matches the given values.
+static bool isTrace(uint8_t i, uint8_t tracePoint, uint16_t now,
+    uint8_t detail) {
+  return i < numTraces
+      && traces[i].button == &button
+      && traces[i].tracePoint == tracePoint
+      && traces[i].now == now
+      && traces[i].detail == detail;
+}
+
+test(TraceHooks, postponed_click_release) {
+  initButton(ButtonConfig::kFeatureDoubleClick
+      | ButtonConfig::kFeatureSuppressClickBeforeDoubleClick);
+
+  helper.pressButton(100);
+  helper.checkTime(120);
+  helper.releaseButton(200);
+  helper.checkTime(220);
+  helper.checkTime(1000);
+
+  // The click is reclaimed just after it is released.
+  assertEqual(8, numTraces);
+  assertTrue(isTrace(0, kTraceDebounceStart, 100, LOW));
+  assertTrue(isTrace(1, kTraceDebounceEnd, 120, LOW));
+  assertTrue(isTrace(2, kTraceDebounceStart, 200, HIGH));
+  assertTrue(isTrace(3, kTraceDebounceEnd, 220, HIGH));
+  assertTrue(isTrace(4, kTraceClickWindowEnter, 220, 0));
+  assertTrue(isTrace(5, kTraceClickPostponed, 220, 0));
+  assertTrue(isTrace(6, kTracePostponedClickRelease, 1000, 0));
+  assertTrue(isTrace(7, kTraceOrphanedClickReclaim, 1000, 0));
+}
+
+test(TraceHooks, orphaned_click_reclaim) {
+  initButton(ButtonConfig::kFeatureClick);
+
+  helper.pressButton(100);
+  helper.checkTime(120);
+  helper.releaseButton(200);
+  helper.checkTime(220);
+  helper.checkTime(1000);
+
+  assertEqual(6, numTraces);
+  assertTrue(isTrace(4, kTraceClickWindowEnter, 220, 0));
+  assertTrue(isTrace(5, kTraceOrphanedClickReclaim, 1000, 0));
+}
+
+test(TraceHooks, double_click_suppresses_clicks) {
+  initButton(ButtonConfig::kFeatureDoubleClick
+      | ButtonConfig::kFeatureSuppressClickBeforeDoubleClick);
+
+  helper.pressButton(100);
+  helper.checkTime(120);
+  helper.releaseButton(200);
+  helper.checkTime(220);
+  helper.pressButton(300);
+  helper.checkTime(320);
+  helper.releaseButton(400);
+  helper.checkTime(420);
+
+  // The postponed first click is cancelled, then the second click is
+  // suppressed.
+  assertEqual(12, numTraces);
+  assertTrue(isTrace(9, kTraceDebounceEnd, 420, HIGH));
+  assertTrue(isTrace(10, kTraceSuppressed, 420, AceButton::kEventClicked));
+  assertTrue(isTrace(11, kTraceSuppressed, 420, AceButton::kEventClicked));
+}
+
+test(TraceHooks, suppressed_release_and_bounce) {
+  initButton(ButtonConfig::kFeatureLongPress
+      | ButtonConfig::kFeatureSuppressAfterLongPress);
+
+  // A bounce ends the debouncing in the previous state.
+  helper.pressButton(100);
+  helper.releaseButton(110);
+  helper.checkTime(120);
+  assertTrue(isTrace(0, kTraceDebounceStart, 100, LOW));
+  assertTrue(isTrace(1, kTraceDebounceEnd, 120, HIGH));
+
+  helper.pressButton(200);
+  helper.checkTime(220);
+  helper.checkTime(1300);
+  helper.releaseButton(1400);
+  helper.checkTime(1420);
+
+  assertEqual(7, numTraces);
+  assertTrue(isTrace(6, kTraceSuppressed, 1420, AceButton::kEventReleased));
+}
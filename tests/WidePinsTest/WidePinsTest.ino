@@ -0,0 +1,136 @@
+#line 2 "WidePinsTest.ino"
+
+// Verify that ACE_BUTTON_WIDE_PINS=1 (set in the Makefile) supports more than
+// 255 virtual buttons.
+
+#include <AUnit.h>
+#include <AceButton.h>
+#include <ace_button/testing/TestableLadderButtonConfig.h>
+#include <ace_button/testing/EventTracker.h>
+
+using namespace aunit;
+using namespace ace_button;
+using namespace ace_button::testing;
+
+// --------------------------------------------------------------------------
+
+static_assert(sizeof(PinType) == 2, "ACE_BUTTON_WIDE_PINS not enabled");
+
+// 9 encoder pins support up to 511 buttons. Use 300.
+static const uint8_t NUM_PINS = 9;
+static const uint8_t PINS[NUM_PINS] = {2, 3, 4, 5, 6, 7, 8, 9, 10};
+static const PinType NUM_BUTTONS = 300;
+
+// An EncodedButtonConfigN with a fake clock and virtual pin.
+class TestableConfig: public EncodedButtonConfigN<NUM_BUTTONS> {
+  public:
+    TestableConfig(): EncodedButtonConfigN<NUM_BUTTONS>(NUM_PINS, PINS) {}
+
+    unsigned long getClock() override { return mMillis; }
+    PinType getVirtualPin() const override { return mVirtualPin; }
+
+    unsigned long mMillis = 0;
+    PinType mVirtualPin = 0;
+};
+
+static TestableConfig testableConfig;
+// A LadderButtonConfig of 300 buttons referenced through an array of
+// pointers, with ids (1000 + i) which differ from their virtual pins (i).
+static const PinType NUM_LADDER_BUTTONS = 300;
+static const PinType NUM_LADDER_LEVELS = NUM_LADDER_BUTTONS + 1;
+static uint16_t ladderLevels[NUM_LADDER_LEVELS];
+static AceButton ladderButtons[NUM_LADDER_BUTTONS];
+static AceButton* ladderButtonPointers[NUM_LADDER_BUTTONS];
+
+static EventTracker eventTracker;
+static IdType lastId;
+
+void handleEvent(AceButton* button, uint8_t eventType, uint8_t buttonState) {
+  eventTracker.addEvent(button->getPin(), eventType, buttonState);
+  lastId = button->getId();
+}
+
+void setup() {
+#if ! defined(EPOXY_DUINO)
+  delay(1000); // wait to prevent garbage on SERIAL_PORT_MONITOR
+#endif
+
+  SERIAL_PORT_MONITOR.begin(115200);
+  while (!SERIAL_PORT_MONITOR); // wait until ready - Leonardo/Micro only
+
+  testableConfig.setEventHandler(handleEvent);
+}
+
+void loop() {
+  TestRunner::run();
+}
+
+// --------------------------------------------------------------------------
+
+test(WidePins, button_pin_and_id) {
+  AceButton button(nullptr, 1000, HIGH, 2000);
+  assertEqual((PinType) 1000, button.getPin());
+  assertEqual((IdType) 2000, button.getId());
+}
+
+test(WidePins, press_virtual_pin_above_255) {
+  eventTracker.clear();
+
+  // Initialization phase.
+  testableConfig.mMillis = 0;
+  testableConfig.checkButtons();
+  testableConfig.mMillis = 50;
+  testableConfig.checkButtons();
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Press the button with virtual pin 290, which is at index 289.
+  testableConfig.mVirtualPin = 290;
+  testableConfig.mMillis = 100;
+  testableConfig.checkButtons();
+  testableConfig.mMillis = 130;
+  testableConfig.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual((PinType) 290, eventTracker.getRecord(0).getPin());
+  assertEqual((IdType) 289, lastId);
+}
+
+test(WidePins, ladder_with_more_than_255_buttons) {
+  // The config binds the buttons in its constructor, so it is created after
+  // the array of pointers.
+  for (PinType i = 0; i < NUM_LADDER_LEVELS; i++) {
+    ladderLevels[i] = i * 10;
+  }
+  for (PinType i = 0; i < NUM_LADDER_BUTTONS; i++) {
+    ladderButtons[i].init(nullptr, i, HIGH, 1000 + i);
+    ladderButtonPointers[i] = &ladderButtons[i];
+  }
+  TestableLadderButtonConfig ladderConfig(0 /*pin*/, NUM_LADDER_LEVELS,
+      ladderLevels, NUM_LADDER_BUTTONS, ladderButtonPointers);
+  ladderConfig.setEventHandler(handleEvent);
+  eventTracker.clear();
+
+  // Initialization phase, no button pressed.
+  ladderConfig.setVirtualPin(NUM_LADDER_LEVELS - 1);
+  ladderConfig.setClock(0);
+  ladderConfig.checkButtons();
+  ladderConfig.setClock(50);
+  ladderConfig.checkButtons();
+  assertEqual(0, eventTracker.getNumEvents());
+
+  // Press the button at index 280, above the range of uint8_t.
+  ladderConfig.setVirtualPin(280);
+  ladderConfig.setClock(100);
+  ladderConfig.checkButtons();
+  ladderConfig.setClock(130);
+  ladderConfig.checkButtons();
+  assertEqual(1, eventTracker.getNumEvents());
+  assertEqual(AceButton::kEventPressed,
+      eventTracker.getRecord(0).getEventType());
+  assertEqual((PinType) 280, eventTracker.getRecord(0).getPin());
+  assertEqual((IdType) 1280, lastId);
+
+  // The button at index 24 (280 truncated to 8 bits) is not pressed.
+  assertEqual((uint8_t) HIGH, ladderButtons[24].getLastButtonState());
+}